@@ -0,0 +1,81 @@
+/*
+ *     ____              __          __          __
+ *    / __ \____ _____ _/ /_        / /_  ____  / /_
+ *   / /_/ / __ `/ __ `/ __ \______/ __ \/ __ \/ __/
+ *  / _, _/ /_/ / /_/ / /_/ /_____/ /_/ / /_/ / /_
+ * /_/ |_|\__,_/\__,_/_.___/     /_.___/\____/\__/
+ *
+ * Copyright (c) 2024 de-Manzanares
+ * This work is released under the MIT license.
+ *
+ */
+
+#ifndef INCLUDE_ATTACK_MAP_H_
+#define INCLUDE_ATTACK_MAP_H_
+
+#include "Board.h"
+
+#include <array>
+#include <cstdint>
+
+/**
+ * @class Attack_Map
+ * @brief The squares every piece attacks, kept up to date move by move
+ * @details Holds the attack set of the piece on each square, the union of
+ * them for each color, and how many pieces of each color attack each square.
+ * After a move only the squares whose contents changed and the sliders whose
+ * rays reach one of them are recomputed, since no other attack set can have
+ * changed. Kept apart from Board so that Board stays small enough to copy.
+ */
+class Attack_Map {
+ public:
+  /// @param board The position to map, computed from scratch
+  explicit Attack_Map(const Board &board);
+
+  /**
+   * @brief Bring the map up to date after one move
+   * @param board The board just after do_move or undo_move; the map must
+   * describe the position one move before
+   */
+  void update(const Board &board);
+
+  /// @return The squares the piece on sq attacks, 0 if it is empty
+  [[nodiscard]] uint64_t attacks_from(const Square sq) const {
+    return _from[static_cast<int>(sq)];
+  }
+
+  /// @return Every square attacked by at least one piece of color c
+  [[nodiscard]] uint64_t attacks(const Color c) const {
+    return _by_color[static_cast<int>(c)];
+  }
+
+  /// @return The number of pieces of color c attacking sq
+  [[nodiscard]] int count(const Color c, const Square sq) const {
+    return _count[static_cast<int>(c)][static_cast<int>(sq)];
+  }
+
+  /// @return True if the king of color c is attacked
+  [[nodiscard]] bool in_check(const Color c) const {
+    Color enemy = c;
+    !enemy;
+    return _kings[static_cast<int>(c)] & attacks(enemy);
+  }
+
+  bool operator==(const Attack_Map &rhs) const = default;
+
+ private:
+  /// @return The squares attacked by the piece on sq in board, 0 if empty
+  static uint64_t piece_attacks(const Board &board, Square sq);
+
+  /// @brief Replace the attack set of sq, adjusting the counts of its owner
+  void set(Square sq, Color c, uint64_t attacks);
+
+  std::array<uint64_t, 64> _from{};                ///< per square
+  std::array<Color, 64> _owner{};                  ///< color of each set
+  std::array<uint64_t, 2> _by_color{};             ///< union per color
+  std::array<std::array<uint8_t, 64>, 2> _count{}; ///< attackers per color
+  std::array<uint64_t, 2> _occupied{};             ///< pieces per color
+  std::array<uint64_t, 2> _kings{};                ///< king per color
+};
+
+#endif // INCLUDE_ATTACK_MAP_H_
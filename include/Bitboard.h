@@ -0,0 +1,348 @@
+/*
+ *     ____              __          __          __
+ *    / __ \____ _____ _/ /_        / /_  ____  / /_
+ *   / /_/ / __ `/ __ `/ __ \______/ __ \/ __ \/ __/
+ *  / _, _/ /_/ / /_/ / /_/ /_____/ /_/ / /_/ / /_
+ * /_/ |_|\__,_/\__,_/_.___/     /_.___/\____/\__/
+ *
+ * Copyright (c) 2024 de-Manzanares
+ * This work is released under the MIT license.
+ *
+ */
+
+#ifndef INCLUDE_BITBOARD_H_
+#define INCLUDE_BITBOARD_H_
+
+#include "Square.h"
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define RAAB_BOT_X86_64
+#endif
+
+/**
+ * @namespace bitboard
+ * @brief Helpers for working with sets of squares packed into a uint64_t
+ * @details Bit n of a bitboard is the square whose Square value is n, so h1 is
+ * the least significant bit and a8 the most significant.
+ */
+namespace bitboard {
+
+constexpr uint64_t FILE_H = 0x0101010101010101ULL; ///< h1, h2, ... h8
+constexpr uint64_t FILE_A = 0x8080808080808080ULL; ///< a1, a2, ... a8
+constexpr uint64_t RANK_1 = 0x00000000000000FFULL; ///< h1, g1, ... a1
+constexpr uint64_t RANK_8 = 0xFF00000000000000ULL; ///< h8, g8, ... a8
+
+/// @return A bitboard with only the given square set
+constexpr uint64_t square(const Square sq) {
+  return 1ULL << static_cast<int>(sq);
+}
+
+/**
+ * @brief Shift every square of a bitboard by a number of files and ranks
+ * @details Squares that would leave the board are dropped.
+ * @param b The bitboard to shift
+ * @param files Files toward the a-file (+) or toward the h-file (-)
+ * @param ranks Ranks toward the 8th rank (+) or toward the 1st rank (-)
+ * @return The shifted bitboard
+ */
+constexpr uint64_t shift(uint64_t b, const int files, const int ranks) {
+  for (int i = 0; i < files; ++i) {
+    b = (b & ~FILE_A) << 1;
+  }
+  for (int i = 0; i > files; --i) {
+    b = (b & ~FILE_H) >> 1;
+  }
+  return ranks >= 0 ? b << (8 * ranks) : b >> (-8 * ranks);
+}
+
+/**
+ * @brief Every square from the given squares to the edge in one direction
+ * @param b The squares to start from, which are not included
+ * @param files Files per step toward the a-file (+) or the h-file (-)
+ * @param ranks Ranks per step toward the 8th rank (+) or the 1st rank (-)
+ * @return The squares along the ray, ignoring any blockers
+ */
+constexpr uint64_t ray(uint64_t b, const int files, const int ranks) {
+  uint64_t ray = 0;
+  while ((b = shift(b, files, ranks))) {
+    ray |= b;
+  }
+  return ray;
+}
+
+/// @return The lowest set square of a non-empty bitboard
+inline Square lsb(const uint64_t b) {
+  return static_cast<Square>(std::countr_zero(b));
+}
+
+/// @return The lowest set square of a non-empty bitboard, which is then cleared
+inline Square pop_lsb(uint64_t &b) {
+  const Square sq = lsb(b);
+  b &= b - 1;
+  return sq;
+}
+
+/// @return The number of squares in the bitboard
+inline int count(const uint64_t b) { return std::popcount(b); }
+
+/**
+ * @brief Expand a bitboard into a list of squares
+ * @param b The bitboard to expand
+ * @return The set squares, lowest first
+ */
+inline std::vector<Square> squares(uint64_t b) {
+  std::vector<Square> v{};
+  v.reserve(count(b));
+  while (b) {
+    v.push_back(pop_lsb(b));
+  }
+  return v;
+}
+
+/**
+ * @brief Parallel bit extract: gather the bits of b selected by mask into the
+ * low bits of the result
+ * @warning Only call when Attacks::backend is Slider_Backend::pext
+ */
+#if defined(RAAB_BOT_X86_64) && (defined(__BMI2__) || defined(_MSC_VER))
+inline uint64_t pext(const uint64_t b, const uint64_t mask) {
+  return _pext_u64(b, mask);
+}
+#else
+uint64_t pext(uint64_t b, uint64_t mask);
+#endif
+
+} // namespace bitboard
+
+/**
+ * @struct Geometry
+ * @brief Lines of the board, computed at compile time
+ * @details Files are numbered from the a-file (0) to the h-file (7) and ranks
+ * from the 1st rank (0) to the 8th (7). Diagonals run from a1 toward h8 and
+ * anti-diagonals from h1 toward a8; both are numbered 0 to 14.
+ */
+struct Geometry {
+  /// the eight directions a queen moves in, as {files, ranks}
+  static constexpr std::array<std::array<int, 2>, 8> directions{
+      {{0, 1}, {0, -1}, {1, 0}, {-1, 0}, {1, 1}, {-1, 1}, {1, -1}, {-1, -1}}};
+
+  /// file of each square, 0 for the a-file
+  static constexpr std::array<uint8_t, 64> file = [] {
+    std::array<uint8_t, 64> table{};
+    for (int sq = 0; sq < 64; ++sq) {
+      table[sq] = static_cast<uint8_t>(7 - sq % 8);
+    }
+    return table;
+  }();
+
+  /// rank of each square, 0 for the 1st rank
+  static constexpr std::array<uint8_t, 64> rank = [] {
+    std::array<uint8_t, 64> table{};
+    for (int sq = 0; sq < 64; ++sq) {
+      table[sq] = static_cast<uint8_t>(sq / 8);
+    }
+    return table;
+  }();
+
+  /// a1-h8 diagonal of each square, 0 for h1 and 14 for a8
+  static constexpr std::array<uint8_t, 64> diagonal = [] {
+    std::array<uint8_t, 64> table{};
+    for (int sq = 0; sq < 64; ++sq) {
+      table[sq] = static_cast<uint8_t>(rank[sq] - file[sq] + 7);
+    }
+    return table;
+  }();
+
+  /// h1-a8 anti-diagonal of each square, 0 for a1 and 14 for h8
+  static constexpr std::array<uint8_t, 64> anti_diagonal = [] {
+    std::array<uint8_t, 64> table{};
+    for (int sq = 0; sq < 64; ++sq) {
+      table[sq] = static_cast<uint8_t>(rank[sq] + file[sq]);
+    }
+    return table;
+  }();
+
+  /// squares strictly between two squares on a shared line, otherwise 0
+  static constexpr std::array<std::array<uint64_t, 64>, 64> between = [] {
+    std::array<std::array<uint64_t, 64>, 64> table{};
+    for (int a = 0; a < 64; ++a) {
+      for (const auto &[files, ranks] : directions) {
+        uint64_t ray = 0;
+        for (uint64_t b = bitboard::shift(1ULL << a, files, ranks); b;
+             b = bitboard::shift(b, files, ranks)) {
+          table[a][std::countr_zero(b)] = ray;
+          ray |= b;
+        }
+      }
+    }
+    return table;
+  }();
+
+  /// the whole line through two squares, both included, otherwise 0
+  static constexpr std::array<std::array<uint64_t, 64>, 64> line = [] {
+    std::array<std::array<uint64_t, 64>, 64> table{};
+    for (int a = 0; a < 64; ++a) {
+      for (const auto &[files, ranks] : directions) {
+        const uint64_t forward = bitboard::ray(1ULL << a, files, ranks);
+        const uint64_t full =
+            forward | bitboard::ray(1ULL << a, -files, -ranks) | 1ULL << a;
+        for (uint64_t b = forward; b; b &= b - 1) {
+          table[a][std::countr_zero(b)] = full;
+        }
+      }
+    }
+    return table;
+  }();
+
+};
+
+/**
+ * @enum Slider_Backend
+ * @brief How slider attack tables are indexed
+ */
+enum class Slider_Backend {
+  magic, ///< multiply by a magic number and shift, runs anywhere
+  pext   ///< BMI2 parallel bit extract, chosen when the CPU has a fast one
+};
+
+/**
+ * @struct Magic
+ * @brief Maps the blockers of one slider on one square to its attack set
+ * @details The relevant occupancy is multiplied by a magic number so that
+ * every blocker configuration lands on an index holding the right attack set.
+ */
+struct Magic {
+  uint64_t mask;     ///< squares whose occupancy matters, edges excluded
+  uint64_t magic;    ///< multiplier giving a collision-free index
+  uint64_t *attacks; ///< this square's slice of the attack table
+  unsigned shift;    ///< 64 minus the number of bits in mask
+
+  /// @return Index into attacks for the given occupancy (magic backend)
+  [[nodiscard]] unsigned index(const uint64_t occupied) const {
+    return static_cast<unsigned>(((occupied & mask) * magic) >> shift);
+  }
+
+  /// @return Index into attacks for the given occupancy (pext backend)
+  [[nodiscard]] unsigned pext_index(const uint64_t occupied) const {
+    return static_cast<unsigned>(bitboard::pext(occupied, mask));
+  }
+};
+
+/**
+ * @struct Attacks
+ * @brief Attack sets for every piece type
+ * @details Knight, king and pawn attacks don't depend on occupancy and are
+ * computed at compile time. Slider attacks are looked up in tables built once
+ * at startup, indexed with PEXT where the CPU does it fast and with magic
+ * bitboards everywhere else.
+ */
+struct Attacks {
+  /// squares attacked by a knight on a given square
+  static constexpr std::array<uint64_t, 64> knight = [] {
+    std::array<uint64_t, 64> table{};
+    for (int sq = 0; sq < 64; ++sq) {
+      const uint64_t b = 1ULL << sq;
+      table[sq] = bitboard::shift(b, 1, 2) | bitboard::shift(b, -1, 2) |
+                  bitboard::shift(b, 2, 1) | bitboard::shift(b, -2, 1) |
+                  bitboard::shift(b, 2, -1) | bitboard::shift(b, -2, -1) |
+                  bitboard::shift(b, 1, -2) | bitboard::shift(b, -1, -2);
+    }
+    return table;
+  }();
+
+  /// squares attacked by a king on a given square
+  static constexpr std::array<uint64_t, 64> king = [] {
+    std::array<uint64_t, 64> table{};
+    for (int sq = 0; sq < 64; ++sq) {
+      const uint64_t b = 1ULL << sq;
+      table[sq] = bitboard::shift(b, 1, 1) | bitboard::shift(b, 0, 1) |
+                  bitboard::shift(b, -1, 1) | bitboard::shift(b, 1, 0) |
+                  bitboard::shift(b, -1, 0) | bitboard::shift(b, 1, -1) |
+                  bitboard::shift(b, 0, -1) | bitboard::shift(b, -1, -1);
+    }
+    return table;
+  }();
+
+  /// squares attacked by a pawn of a given color on a given square
+  static constexpr std::array<std::array<uint64_t, 64>, 2> pawn = [] {
+    std::array<std::array<uint64_t, 64>, 2> table{};
+    for (int sq = 0; sq < 64; ++sq) {
+      const uint64_t b = 1ULL << sq;
+      table[static_cast<int>(Color::white)][sq] =
+          bitboard::shift(b, 1, 1) | bitboard::shift(b, -1, 1);
+      table[static_cast<int>(Color::black)][sq] =
+          bitboard::shift(b, 1, -1) | bitboard::shift(b, -1, -1);
+    }
+    return table;
+  }();
+
+  static std::array<Magic, 64> rook_magics;   ///< rook magic for each square
+  static std::array<Magic, 64> bishop_magics; ///< bishop magic for each square
+  static Slider_Backend backend; ///< indexing scheme the tables were built for
+
+  /// @return Index into a slider's attacks for the given occupancy
+  static unsigned index(const Magic &m, const uint64_t occupied) {
+    return backend == Slider_Backend::pext ? m.pext_index(occupied)
+                                           : m.index(occupied);
+  }
+
+  /**
+   * @brief Squares attacked by a rook
+   * @param sq The square the rook is on
+   * @param occupied Every occupied square on the board
+   * @return The attack set, including the first blocker in each direction
+   */
+  static uint64_t rook(const Square sq, const uint64_t occupied) {
+    const Magic &m = rook_magics[static_cast<int>(sq)];
+    return m.attacks[index(m, occupied)];
+  }
+
+  /**
+   * @brief Squares attacked by a bishop
+   * @param sq The square the bishop is on
+   * @param occupied Every occupied square on the board
+   * @return The attack set, including the first blocker in each direction
+   */
+  static uint64_t bishop(const Square sq, const uint64_t occupied) {
+    const Magic &m = bishop_magics[static_cast<int>(sq)];
+    return m.attacks[index(m, occupied)];
+  }
+
+  /**
+   * @brief Squares attacked by a queen
+   * @param sq The square the queen is on
+   * @param occupied Every occupied square on the board
+   * @return The attack set, including the first blocker in each direction
+   */
+  static uint64_t queen(const Square sq, const uint64_t occupied) {
+    return rook(sq, occupied) | bishop(sq, occupied);
+  }
+
+  /**
+   * @brief Check whether this CPU has a fast PEXT instruction
+   * @details BMI2 must be reported by CPUID. AMD parts before Zen 3 report it
+   * but run PEXT in microcode, so they are left on magic bitboards.
+   * @return True if the pext backend should be used
+   */
+  static bool has_fast_pext();
+
+  /// @return "pext" or "magic", for reporting which backend is active
+  static const char *backend_name();
+
+  /**
+   * @brief Pick a backend, then fill in the slider masks, magics and attack
+   * tables for it
+   * @param b The backend to build the tables for
+   * @note Runs automatically during static initialization of Bitboard.cpp
+   * with the fastest backend the CPU supports
+   */
+  static void init(Slider_Backend b);
+};
+
+#endif // INCLUDE_BITBOARD_H_
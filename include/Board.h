@@ -13,93 +13,147 @@
 #ifndef INCLUDE_BOARD_H_
 #define INCLUDE_BOARD_H_
 
+#include "Bitboard.h"
 #include "Game_State.h"
+#include "Move.h"
 #include "Square.h"
+#include "Zobrist.h"
 
+#include <array>
 #include <cstdint>
 #include <sstream>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 
 /**
- * @struct Diagonals
- * @brief Groups the diagonals of the board for answering the question "are
- * these squares in the same diagonal?"
+ * @struct Undo
+ * @brief What Board::undo_move needs to take a move back
+ * @details The rest of the position can be worked out from the move itself.
  */
-struct Diagonals {
-  static std::vector<std::vector<Square>>
-      leftRight; ///< left to right {diagonal,{squares}}
-  static std::vector<std::vector<Square>>
-      rightLeft; ///< right to left {diagonal,{squares}}
+struct Undo {
+  uint64_t key;             ///< Zobrist key before the move
+  Square en_passant_target; ///< en passant target before the move
+  uint16_t half_move_clock; ///< half move clock before the move
+  uint8_t captured;         ///< mailbox code of the captured piece, 0 if none
+  uint8_t castling;         ///< castling rights before the move
 };
 
 /**
- * @class Maps
- * @brief A collection of unordered maps used for move generation
+ * @struct Check_Info
+ * @brief What Board::is_legal needs to know about a position, worked out once
+ * for all of its moves
  */
-struct Maps {
-  // influence - possible moves, squares under attack/defense by this piece
-  std::unordered_map<Square, std::vector<Square>>
-      white_influence{}; ///< all white influence
-  std::unordered_map<Square, std::vector<Square>>
-      black_influence{}; ///< all black influence
-  std::unordered_map<Square, Square>
-      white_pinned{}; ///< {pinned piece, pinning piece}
-  std::unordered_map<Square, Square>
-      black_pinned{}; ///< {pinned piece, pinning piece}
-  std::unordered_map<Square, std::vector<Square>>
-      white_moves{}; ///< all legal white moves
-  std::unordered_map<Square, std::vector<Square>>
-      black_moves{}; ///< all legal black moves
-  void clear();
+struct Check_Info {
+  uint64_t pinned;   ///< the side to move's pieces pinned to its king
+  uint64_t checkers; ///< the enemy pieces giving check
 };
 
+/**
+ * @brief A position in 32 bytes, for storing and exchanging positions in bulk
+ * @details Made by Board::encode and read by Board::decode. Multi-byte fields
+ * are little-endian, so the bytes mean the same on every platform.
+ * - bytes 0-7: the occupied squares, bit n for square n (h1 = 0)
+ * - bytes 8-23: the mailbox code of each occupied piece, in square order, two
+ *   per byte with the lower square in the low nibble; unused nibbles are 0
+ * - byte 24: bit 0 set if black is to move, bits 1-4 the castling rights
+ * - byte 25: the en passant target, 64 if there is none
+ * - bytes 26-27: the half move clock
+ * - bytes 28-29: the full move number
+ * - bytes 30-31: reserved, 0
+ */
+using Packed_Position = std::array<uint8_t, 32>;
+
 /**
  * @struct Board
  * @brief Represents the chessboard
  * @details Stores all relevant game-state data and enforces rules during move
  * generation.
- * @note Bitboards are initialized with standard startpos.
+ * @note Bitboards are initialized with standard startpos. Board is trivially
+ * copyable and allocates nothing, so copying one is a single memcpy.
  */
 struct Board {
-  ~Board();
-  /**
-   * @brief Copy assignment operator
-   * @param rhs The Board object to be copied
-   * @return A reference to the lhs object after assignment
-   */
-  Board &operator=(const Board &rhs);
+  /// characters of the pieces, in the order of the mailbox codes
+  static constexpr char PIECE_CHARS[] = " PNBRQKpnbrqk";
+
+  /// value of each Piece in centipawns when trading, as in Eval
+  static constexpr std::array<int, 7> SEE_VALUE = {100, 300, 310, 500,
+                                                   900, 0,   0};
+
   // clang-format off
-  uint64_t b_pawn   = 0b00000000'11111111'00000000'00000000'00000000'00000000'00000000'00000000;    ///< black pawn
-  uint64_t b_night  = 0b01000010'00000000'00000000'00000000'00000000'00000000'00000000'00000000;    ///< black knight
-  uint64_t b_bishop = 0b00100100'00000000'00000000'00000000'00000000'00000000'00000000'00000000;    ///< black bishop
-  uint64_t b_rook   = 0b10000001'00000000'00000000'00000000'00000000'00000000'00000000'00000000;    ///< black rook
-  uint64_t b_queen  = 0b00010000'00000000'00000000'00000000'00000000'00000000'00000000'00000000;    ///< black queen
-  uint64_t b_king   = 0b00001000'00000000'00000000'00000000'00000000'00000000'00000000'00000000;    ///< black king
-  uint64_t w_Pawn   = 0b00000000'00000000'00000000'00000000'00000000'00000000'11111111'00000000;    ///< white pawn
-  uint64_t w_Night  = 0b00000000'00000000'00000000'00000000'00000000'00000000'00000000'01000010;    ///< white knight
-  uint64_t w_Bishop = 0b00000000'00000000'00000000'00000000'00000000'00000000'00000000'00100100;    ///< white bishop
-  uint64_t w_Rook   = 0b00000000'00000000'00000000'00000000'00000000'00000000'00000000'10000001;    ///< white rook
-  uint64_t w_Queen  = 0b00000000'00000000'00000000'00000000'00000000'00000000'00000000'00010000;    ///< white queen
-  uint64_t w_King   = 0b00000000'00000000'00000000'00000000'00000000'00000000'00000000'00001000;    ///< white king
+  /// one bitboard per kind of piece, both colors together; indexed by Piece
+  std::array<uint64_t, 6> by_piece = {
+      0b00000000'11111111'00000000'00000000'00000000'00000000'11111111'00000000, // pawns
+      0b01000010'00000000'00000000'00000000'00000000'00000000'00000000'01000010, // knights
+      0b00100100'00000000'00000000'00000000'00000000'00000000'00000000'00100100, // bishops
+      0b10000001'00000000'00000000'00000000'00000000'00000000'00000000'10000001, // rooks
+      0b00010000'00000000'00000000'00000000'00000000'00000000'00000000'00010000, // queens
+      0b00001000'00000000'00000000'00000000'00000000'00000000'00000000'00001000, // kings
+  };
+
+  /// one bitboard per color; indexed by Color
+  std::array<uint64_t, 2> by_color = {
+      0b00000000'00000000'00000000'00000000'00000000'00000000'11111111'11111111, // white
+      0b11111111'11111111'00000000'00000000'00000000'00000000'00000000'00000000, // black
+  };
+
+  /// The piece on each square as an index into PIECE_CHARS (0 if empty), two
+  /// squares per byte. Even squares use the low four bits.
+  std::array<uint8_t, 32> mailbox = [] {
+    constexpr char startpos[] = "RNBKQBNR" "PPPPPPPP" "        " "        "
+                                "        " "        " "pppppppp" "rnbkqbnr";
+    std::array<uint8_t, 32> squares{};
+    for (int i = 0; i < 64; ++i) {
+      int code = 0;
+      while (PIECE_CHARS[code] != startpos[i]) {
+        ++code;
+      }
+      squares[i / 2] |= static_cast<uint8_t>(code << (i % 2 * 4));
+    }
+    return squares;
+  }();
   // clang-format on
 
   Game_State game_state; ///< game conditions aside from piece placement
 
-  Maps *maps = new Maps; ///< for move generation
+  /// Zobrist key of the position, kept up to date as pieces and state change
+  uint64_t key = compute_key();
+
+  /// @return The pieces of one kind and color
+  [[nodiscard]] uint64_t pieces(const Color c, const Piece p) const {
+    return by_piece[static_cast<int>(p)] & by_color[static_cast<int>(c)];
+  }
+
+  /// @return The index into PIECE_CHARS of the piece on a square, 0 if empty
+  [[nodiscard]] int mailbox_code(const Square sq) const {
+    const int i = static_cast<int>(sq);
+    return mailbox[i / 2] >> (i % 2 * 4) & 0xF;
+  }
 
-  /// Maps character code to the respective bitboard.
-  std::unordered_map<char, uint64_t &> piece_map = {
-      {'p', b_pawn},   {'n', b_night}, {'b', b_bishop}, {'r', b_rook},
-      {'q', b_queen},  {'k', b_king},  {'P', w_Pawn},   {'N', w_Night},
-      {'B', w_Bishop}, {'R', w_Rook},  {'Q', w_Queen},  {'K', w_King}};
+  /// @return The kind of piece on a square, Piece::none if empty
+  [[nodiscard]] Piece piece_on(const Square sq) const {
+    const int code = mailbox_code(sq);
+    return code == 0 ? Piece::none : static_cast<Piece>((code - 1) % 6);
+  }
 
   /**
    * @brief Remove all pieces and clear the game state.
    */
   void clear();
 
+  /**
+   * @brief Compute the Zobrist key of the position from scratch
+   * @return The key that Board::key should hold
+   */
+  [[nodiscard]] uint64_t compute_key() const;
+
+  /**
+   * @return The part of the Zobrist key that comes from castling rights, the en
+   * passant target and the side to move
+   */
+  [[nodiscard]] uint64_t state_key() const;
+
   /**
    * @brief Place a piece on the chessboard
    * @details This function places the specified piece on the given square of
@@ -107,9 +161,10 @@ struct Board {
    * specified by a value from the Square enum.
    * @param square The square on the chessboard where the piece should be placed
    * @param ch The character representing the piece to be placed
+   * @note Keeps the piece, color and mailbox views of the board in sync
    * @warning assumes the given square is empty
    */
-  void place_piece(Square square, const char &ch) const;
+  void place_piece(Square square, const char &ch);
 
   // piece detection
   /**
@@ -291,89 +346,38 @@ struct Board {
    */
   bool is_opposite_king(Square sq, Color c) const;
 
+  /// @return Every occupied square on the board
+  uint64_t occupied() const;
+
+  /// @return Every square occupied by a piece of the given color
+  uint64_t occupied(Color c) const;
+
+  /**
+   * @brief The occupancy a slider on the given square sees
+   * @details The enemy king is left out so that influence continues through
+   * it; the king cannot escape a slider by stepping back along its ray.
+   * @param sq The square of the slider
+   * @return Every occupied square except the enemy king
+   */
+  uint64_t xray_occupancy(Square sq) const;
+
   /**
    * @brief Get the row of a given square
    * @param sq The square to check
    * @return The number of the row
    */
-  static int get_row(Square sq);
+  static int get_row(const Square sq) {
+    return Geometry::rank[static_cast<int>(sq)] + 1;
+  }
 
   /**
    * @brief Get the column of a given square
    * @param sq The square to check
    * @return The column number. (a:h) = (1:8)
    */
-  static int get_column(Square sq);
-
-  /**
-   * @brief Check if two squares are in the same row.
-   * @param sq1 The first square.
-   * @param sq2 The second square.
-   * @return True if the squares are in the same row, false otherwise.
-   */
-  static bool is_inSameRow(Square sq1, Square sq2);
-
-  /**
-   * @brief Check if three squares are in the same row
-   * @param sq1 First square
-   * @param sq2 Second square
-   * @param sq3 Third square
-   * @return True if all three squares are in the same row, false otherwise
-   */
-  static bool is_inSameRow(Square sq1, Square sq2, Square sq3);
-
-  /**
-   * @brief Check if two squares are in the same column
-   * @param sq1 The first square
-   * @param sq2 The second square
-   * @return True if the squares are in the same column, false otherwise
-   */
-  static bool is_inSameColumn(Square sq1, Square sq2);
-
-  /**
-   * Check if three squares are in the same column.
-   * @param sq1 First square.
-   * @param sq2 Second square.
-   * @param sq3 Third square.
-   * @return True if all three squares are in the same column, false otherwise.
-   */
-  static bool is_inSameColumn(Square sq1, Square sq2, Square sq3);
-
-  /**
-   * @brief Check if two squares are on the same diagonal (left to right)
-   * @param sq1 The first square
-   * @param sq2 The second square
-   * @return True if the squares are on the same diagonal false otherwise
-   */
-  static bool is_inSameDiagonal_leftRight(Square sq1, Square sq2);
-
-  /**
-   * @brief Check if three squares are in the same diagonal in
-   * Diagonals::leftRight
-   * @param sq1 The first square.
-   * @param sq2 The second square.
-   * @param sq3 The third square.
-   * @return True if the three squares are in the same diagonal, false
-   * otherwise.
-   */
-  static bool is_inSameDiagonal_leftRight(Square sq1, Square sq2, Square sq3);
-
-  /**
-   * @brief Check if two squares are in the same diagonal (right to left)
-   * @param sq1 The first square
-   * @param sq2 The second square
-   * @return True if the squares are in the same diagonal, false otherwise
-   */
-  static bool is_inSameDiagonal_rightLeft(Square sq1, Square sq2);
-
-  /**
-   * @brief Check if three squares are in the same diagonal (right to left)
-   * @param sq1 The first square
-   * @param sq2 The second square
-   * @param sq3 The third square
-   * @return true if the three squares are in the same diagonal, false otherwise
-   */
-  static bool is_inSameDiagonal_rightLeft(Square sq1, Square sq2, Square sq3);
+  static int get_column(const Square sq) {
+    return Geometry::file[static_cast<int>(sq)] + 1;
+  }
 
   // fen
   // fen out
@@ -383,6 +387,18 @@ struct Board {
    */
   std::string fen_piece_placement() const;
 
+  /// the longest FEN write_fen can produce, with room to spare
+  static constexpr std::size_t FEN_MAX = 96;
+
+  /**
+   * @brief Writes the board as FEN into a buffer
+   * @details Allocation-free: pieces come straight from the mailbox and the
+   * clocks go through std::to_chars. No terminating null is written.
+   * @param out The buffer to write to, with room for at least FEN_MAX chars
+   * @return One past the last character written
+   */
+  char *write_fen(char *out) const;
+
   /**
    * @brief Export the current state of the board as FEN (Forsyth–Edwards
    * Notation) string.
@@ -393,36 +409,44 @@ struct Board {
 
   // fen in
   /**
-   * Sets the pieces on the chessboard based on the given FEN string
-   * @param fen The FEN string representing the piece placement
-   * @return The number of characters processed in the FEN string
+   * @brief Sets the board from a FEN string, or the first four fields of an
+   * EPD line
+   * @details Reads the text in place: nothing is copied or allocated, and each
+   * piece letter is looked up in a table. Missing clocks, as in EPD, default
+   * to 0 and 1.
+   * @param fen The text to read, which may go on past the position
+   * @return The number of characters read, so that EPD operations start there,
+   * or 0 if the position is malformed, in which case the board is left empty
    */
-  uint set_pieces(const std::string &fen) const;
+  std::size_t parse_fen(std::string_view fen);
 
   /**
    * @brief Sets the board from a given FEN string.
    * @param fen    The FEN string to import.
    */
-  void import_fen(const std::string &fen);
+  void import_fen(std::string_view fen);
 
-  // begin move generation     ----------------------------------------
+  // packed
   /**
-   * @brief Calculates the legal moves for a pawn on the board
-   * @param sq The square on which the pawn is located
-   * @return A vector of squares representing the legal moves for the pawn
+   * @brief Writes the board as a Packed_Position
+   * @param out The position to write to
+   * @return False if the board holds more than 32 pieces, which don't fit
    */
-  std::vector<Square> legal_moves_pawn(Square sq) const;
+  bool encode(Packed_Position *out) const;
 
   /**
-   * @brief Used for getting pawn moves.
-   * @param sq The square for which to calculate the legal moves
-   * @return A vector of Squares representing the legal moves
+   * @brief Sets the board from a Packed_Position
+   * @param packed The position to read
+   * @return False if the position is malformed, in which case the board is
+   * left empty
    */
-  std::vector<Square> legal_moves(Square sq) const;
+  bool decode(const Packed_Position &packed);
 
+  // begin move generation     ----------------------------------------
   // influence
   /**
    * @brief Computes the influence of a given rook
+   * @details Looked up through the rook magics in Attacks
    * @param sq The square to compute the influence for.
    * @return std::vector<Square> A vector of squares representing the influence
    * of the rook.
@@ -431,6 +455,7 @@ struct Board {
 
   /**
    * @brief Computes the infulence of a given bishop
+   * @details Looked up through the bishop magics in Attacks
    * @param sq The square where the bishop is located.
    * @return std::vector<Square> A vector containing all the squares influenced
    * by the bishop.
@@ -446,6 +471,7 @@ struct Board {
 
   /**
    * @brief Computes the influence of a given knight
+   * @details Read from the precomputed Attacks::knight table
    * @param sq The square where the knight is located.
    * @return A vector of squares influenced by the knight.
    */
@@ -453,6 +479,7 @@ struct Board {
 
   /**
    * @brief Computes the influence of a given king.
+   * @details Read from the precomputed Attacks::king table
    * @param sq The square where the king is located.
    * @return A vector of squares that are influenced by the king.
    */
@@ -460,6 +487,7 @@ struct Board {
 
   /**
    * @brief Calculates the squares influenced by a pawn on the chessboard
+   * @details Read from the precomputed Attacks::pawn table
    * @param sq The square where the pawn is located
    * @return A vector of squares influenced by the pawn
    */
@@ -473,11 +501,6 @@ struct Board {
    */
   std::vector<Square> influence(Square sq) const;
 
-  /**
-   * @brief Update the influence maps for white and black pieces
-   */
-  void update_influence_maps() const;
-
   // pinned pieces
   /**
    * @brief Finds the piece pinned by a given rook
@@ -517,69 +540,162 @@ struct Board {
    */
   Square pinned_piece(Square sq) const;
 
+  // legal moves
   /**
-   * @brief Update the maps of pinned pieces
-   * @details Checks every piece to find pins to the enemy king and records
-   * pinned pieces
-   * @note mutates Maps::black_pinned and Maps::white_pinned
+   * @brief Every piece of either color attacking a square
+   * @param sq The square attacked
+   * @param occupied The occupancy the sliders see
+   * @return The squares of the attackers
    */
-  void update_pinned_pieces() const;
+  uint64_t attackers_to(Square sq, uint64_t occupied) const;
 
-  // influence reduction
   /**
-   * @brief Updates white king moves
-   * @param sq_w_King The current position of the white king.
-   * @return Squares containing pieces that are giving check to the white king.
-   * @note May mutate Game_State::white_inCheck
-   * @warning For move generation as a whole to function properly, there must be
-   * exactly 1 king of each color on the board
+   * @brief Whether any piece of one color attacks a square
+   * @param sq The square attacked
+   * @param by The attacking color
+   * @return True if at least one piece of that color attacks the square
    */
-  std::vector<Square> update_white_king_moves(Square sq_w_King);
+  bool is_attacked(Square sq, Color by) const;
+
+  /**
+   * @brief Static exchange evaluation
+   * @details Plays out every capture on the move's destination, each side
+   * capturing with its least valuable piece and free to stop when going on
+   * would lose more. Sliders lined up behind a capturer join in once it has
+   * moved. Pins are ignored.
+   * @param move A capture, promotion or quiet move of the side to move
+   * @return The material the mover gains, in centipawns, at best for both
+   */
+  int see(Move move) const;
+
+  /**
+   * @brief Whether the static exchange evaluation reaches a threshold
+   * @details Gives the same answer as see(move) >= margin, but stops as soon
+   * as the answer is known.
+   * @param move A capture, promotion or quiet move of the side to move
+   * @param margin The gain, in centipawns, to reach
+   * @return True if the exchange gains at least margin
+   */
+  bool see_ge(Move move, int margin) const;
+
+  /**
+   * @brief Every square attacked by one color
+   * @param c The attacking color
+   * @param occupied The occupancy the sliders see
+   * @return The union of the attack sets of every piece of that color
+   */
+  uint64_t attacked_squares(Color c, uint64_t occupied) const;
+
+  /**
+   * @brief Generates the legal moves of one color
+   * @details Finds the pieces giving check and the pieces pinned to the king,
+   * once, as bitboards. Every piece's attack set is then intersected with the
+   * squares that answer check and with its pin ray, so nothing has to be
+   * filtered afterwards.
+   * @param c The color to generate moves for
+   * @param moves The list to append to
+   * @param type Which of the legal moves to generate
+   * @return True if that color's king is in check
+   */
+  bool generate_moves(Color c, MoveList *moves,
+                      Gen_Type type = Gen_Type::all) const;
+
+  /**
+   * @brief generate_moves for one color, fixed at compile time
+   * @details Both colors are instantiated in Board.cpp; the color-dependent
+   * directions, ranks and castling rights fold into constants.
+   */
+  template <Color Us> bool generate_moves(MoveList *moves, Gen_Type type) const;
+
+  /**
+   * @brief The legal move generator, handing what it finds to a sink
+   * @details The sink receives each piece's target squares as a bitboard, so
+   * counting them is a popcount and nothing has to be written out. It may
+   * also stop the generator early. The sinks live in Board.cpp.
+   * @return True if that color's king is in check
+   */
+  template <Color Us, class Sink>
+  bool generate_legal(Sink &sink, Gen_Type type) const;
+
+  /**
+   * @brief Generates the pseudo-legal moves of one color
+   * @details Every move the pieces can make, ignoring whether it leaves the
+   * king attacked. Castling only checks the rights and that the squares
+   * between king and rook are empty. Pair with is_legal, so that moves cut off
+   * before they are searched are never checked at all.
+   * @param c The color to generate moves for
+   * @param moves The list to append to
+   * @param type Which of the pseudo-legal moves to generate
+   */
+  void generate_pseudo_legal(Color c, MoveList *moves,
+                             Gen_Type type = Gen_Type::all) const;
+
+  /// @brief generate_pseudo_legal for one color, fixed at compile time
+  template <Color Us>
+  void generate_pseudo_legal(MoveList *moves, Gen_Type type) const;
 
   /**
-   * @brief Updates black king moves
-   * @param sq_b_king The current position of the black king.
-   * @return Squares containing pieces that are giving check to the black king.
-   * @note May mutate Game_State::black_inCheck
-   * @warning For move generation as a whole to function properly, there must be
-   * exactly 1 king of each color on the board
+   * @brief Generates the pseudo-legal quiet moves that give check
+   * @details A move checks directly if it lands where its piece attacks the
+   * enemy king, found by looking from the king as that piece. It checks by
+   * discovery if it takes the only piece between one of our sliders and the
+   * king off their line. Promotions are left to the captures, and castling is
+   * not included. Together with Gen_Type::captures this is what a quiescence
+   * search needs.
+   * @param c The color to generate moves for
+   * @param moves The list to append to
    */
-  std::vector<Square> update_black_king_moves(Square sq_b_king);
+  void generate_quiet_checks(Color c, MoveList *moves) const;
+
+  /// @brief generate_quiet_checks for one color, fixed at compile time
+  template <Color Us> void generate_quiet_checks(MoveList *moves) const;
 
   /**
-   * @brief Copies influence maps to move maps, excluding kings and pawns
-   * @details Move generation is done by starting with the influence maps and
-   * reducing the map by applying rules of the game. This function returns the
-   * square of (a) king because we will need that info later, and now is as good
-   * a time as any to get it.
-   * @param c Indicates which map to copy
-   * @param from The unordered_map where the squares will be copied from
-   * @param to The unordered_map where the squares will be assigned
-   * @return The square in which the king resides
+   * @brief Finds the pins and checks against one color's king
+   * @param c The color of the king
+   * @return The pieces pinned to that king and the pieces checking it
    */
-  Square
-  copy_influence(Color c,
-                 const std::unordered_map<Square, std::vector<Square>> *from,
-                 std::unordered_map<Square, std::vector<Square>> *to) const;
+  Check_Info check_info(Color c) const;
 
   /**
-   * @brief Removes same-colored squares from a given map
-   * @details It is not legal to capture your own pieces
-   * @param map Map to remove squares from.
-   * @param color The color of the squares to be removed
+   * @brief Whether a pseudo-legal move leaves the mover's king safe
+   * @details Moves other than king moves and en passant only need the pin and
+   * check masks. A king move tests its destination. En passant, which can
+   * uncover an attack along the rank, is tested in full.
+   * @param move A move from generate_pseudo_legal for this position
+   * @param info check_info of the color making the move
+   * @return True if the move is legal
    */
-  void remove_same_color_squares(
-      Color color, std::unordered_map<Square, std::vector<Square>> *map) const;
+  bool is_legal(Move move, const Check_Info &info) const;
 
   /**
    * @brief Move generation.
-   * @details Move maps are created by starting with all possible moves for a
-   * piece using update_influence_maps(), then reducing this list by applying
-   * various rules of the game
-   * @note Mutates `Maps`
-   * @warning There must be exactly one king of each color on on the board
+   * @param c The color to generate moves for, whether or not it is to move
+   * @return Every legal move of that color
+   * @warning There must be at most one king of each color on on the board
+   */
+  MoveList legal_moves(Color c) const;
+
+  /**
+   * @brief The number of legal moves, without generating them
+   * @param c The color to count moves for, whether or not it is to move
+   * @return legal_moves(c).size(), from the popcounts of the target squares
+   */
+  unsigned count_legal_moves(Color c) const;
+
+  /**
+   * @brief Whether there is any legal move, stopping at the first
+   * @param c The color to look for moves for, whether or not it is to move
+   * @return False if that color is checkmated or stalemated
    */
-  void update_move_maps();
+  bool has_legal_move(Color c) const;
+
+  /**
+   * @brief Check if a king is in check
+   * @param c The color of the king
+   * @return True if the king of that color is attacked
+   */
+  bool in_check(Color c) const;
   // end move generation     ----------------------------------------
 
   // uci
@@ -591,7 +707,7 @@ struct Board {
    * @return The number of nodes at depth 1.
    * @note This is only in use in a test file sample-game.cxx
    */
-  [[maybe_unused]] uint nodes_at_depth_1(Color color);
+  [[maybe_unused]] uint nodes_at_depth_1(Color color) const;
 
   // mutate board
   /**
@@ -606,6 +722,31 @@ struct Board {
    */
   void do_move(Square from, Square to, char ch);
 
+  /**
+   * @brief Moves a piece on the chessboard
+   * @param move A move from legal_moves()
+   * @return What undo_move() needs to take the move back
+   */
+  Undo do_move(Move move);
+
+  /**
+   * @brief Take back a move made with do_move(Move)
+   * @param move The move that was made
+   * @param undo The record do_move() returned for it
+   * @note Moves must be taken back in the reverse order they were made
+   */
+  void undo_move(Move move, const Undo &undo);
+
+  /**
+   * @brief do_move(Move) for the side making the move, fixed at compile time
+   * @details Works from the move's flags rather than what is on the squares,
+   * so the only color tests left are the compile-time ones.
+   */
+  template <Color Us> void make_move(Move move);
+
+  /// @brief undo_move for the side that made the move
+  template <Color Us> void unmake_move(Move move, const Undo &undo);
+
   /**
    * @brief Move a pawn.
    * @details Check for promotion, two square move, or en passant, then move
@@ -617,13 +758,19 @@ struct Board {
 
   /**
    * @brief Removes a piece from the chessboard at the given square.
-   * @details This function updates the bitboards for each piece type by
-   * clearing the bit corresponding to the given square. The piece_map is then
-   * updated to reflect the new bitmaps.
+   * @details Looks the piece up in the mailbox, then clears it from its piece
+   * and color bitboards.
    * @param square The square to remove the piece from
    */
   void remove_piece(Square square);
 
+  /**
+   * @brief Places a piece given by its mailbox code
+   * @param square The square to place it on, which must be empty
+   * @param code The index into PIECE_CHARS of the piece
+   */
+  void place_code(Square square, int code);
+
   /**
    * @brief Move a knight, bishop, or queen.
    * @details There are no special rules to consider when moving these pieces,
@@ -650,4 +797,7 @@ struct Board {
   void move_rook(Square from, Square to);
 };
 
+static_assert(std::is_trivially_copyable_v<Board>);
+static_assert(sizeof(Board) <= 128);
+
 #endif // INCLUDE_BOARD_H_
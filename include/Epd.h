@@ -0,0 +1,125 @@
+/*
+ *     ____              __          __          __
+ *    / __ \____ _____ _/ /_        / /_  ____  / /_
+ *   / /_/ / __ `/ __ `/ __ \______/ __ \/ __ \/ __/
+ *  / _, _/ /_/ / /_/ / /_/ /_____/ /_/ / /_/ / /_
+ * /_/ |_|\__,_/\__,_/_.___/     /_.___/\____/\__/
+ *
+ * Copyright (c) 2024 de-Manzanares
+ * This work is released under the MIT license.
+ *
+ */
+
+#ifndef INCLUDE_EPD_H_
+#define INCLUDE_EPD_H_
+
+#include "Board.h"
+
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class Mapped_File
+ * @brief A read-only view of a whole file
+ * @details Memory-mapped where the platform has mmap, so a file of several
+ * gigabytes is paged in as it is read rather than copied up front; read into
+ * memory elsewhere.
+ */
+class Mapped_File {
+ public:
+  /// @param path The file to open; check is_open() before reading
+  explicit Mapped_File(const std::string &path);
+  ~Mapped_File();
+
+  Mapped_File(const Mapped_File &) = delete;
+  Mapped_File &operator=(const Mapped_File &) = delete;
+
+  /// @return True if the file could be opened and read
+  [[nodiscard]] bool is_open() const { return _open; }
+
+  /// @return The contents of the file
+  [[nodiscard]] std::string_view text() const { return {_data, _size}; }
+
+ private:
+  const char *_data = nullptr; ///< start of the contents
+  std::size_t _size = 0;       ///< length of the contents
+  bool _open = false;          ///< the file was opened
+  std::string _buffer;         ///< the contents, where there is no mmap
+};
+
+/**
+ * @class Fen_Writer
+ * @brief Streams positions to a file as FEN, one per line
+ * @details Each position is formatted with Board::write_fen straight into a
+ * block buffer, and the block goes to the file in a single write once it is
+ * full, so writing millions of positions allocates nothing per position.
+ */
+class Fen_Writer {
+ public:
+  /// @param path The file to create, or truncate; check is_open() first
+  explicit Fen_Writer(const std::string &path);
+  ~Fen_Writer() { flush(); }
+
+  Fen_Writer(const Fen_Writer &) = delete;
+  Fen_Writer &operator=(const Fen_Writer &) = delete;
+
+  /// @return True if the file could be created
+  [[nodiscard]] bool is_open() const { return _file.is_open(); }
+
+  /// @param board The position to append
+  void write(const Board &board);
+
+  /// Writes out whatever is buffered
+  void flush();
+
+ private:
+  static constexpr std::size_t BLOCK = 1 << 20; ///< bytes per write
+
+  std::ofstream _file;      ///< the output
+  std::vector<char> _block; ///< positions not yet written
+  std::size_t _used = 0;    ///< bytes of _block in use
+};
+
+/**
+ * @struct Epd
+ * @brief Loads positions in bulk from FEN or EPD text, one per line
+ * @details Each line is parsed with Board::parse_fen; EPD operations after
+ * the position are ignored. Blank lines, lines starting with '#' and lines
+ * that don't hold a valid position are skipped.
+ */
+struct Epd {
+  /**
+   * @brief Parse every line of a block of text
+   * @details The text is cut into one chunk per thread at line breaks. Each
+   * thread parses its chunk into its own list, and the lists are joined in
+   * order, so the positions come out in the order of the lines.
+   * @param text The lines to parse
+   * @param boards The list to append the positions to
+   * @param threads The number of threads to parse with
+   * @return The number of lines skipped as malformed
+   */
+  static std::size_t parse(std::string_view text, std::vector<Board> *boards,
+                           uint threads = 1);
+
+  /**
+   * @brief Parse every line of a file
+   * @param path The file to read
+   * @param boards The list to append the positions to
+   * @param threads The number of threads to parse with
+   * @return False if the file could not be opened
+   */
+  static bool load(const std::string &path, std::vector<Board> *boards,
+                   uint threads = 1);
+
+  /**
+   * @brief Write positions to a file as FEN, one per line
+   * @param path The file to create, or truncate
+   * @param boards The positions to write
+   * @return False if the file could not be created
+   */
+  static bool save(const std::string &path, const std::vector<Board> &boards);
+};
+
+#endif // INCLUDE_EPD_H_
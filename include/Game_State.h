@@ -15,7 +15,9 @@
 
 #include "Square.h"
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 
 using uint = unsigned int;
 
@@ -23,14 +25,16 @@ using uint = unsigned int;
  * @brief Represents the current state of a game.
  * @details  Stores information such as the active color, castling ability, en
  * passant targets, half move clock, and full move number.
+ * @note Trivially copyable, so that a Board copies with a single memcpy
  */
 struct Game_State {
-  /**
-   * @brief Copy assignment operator
-   * @param rhs The object to be copied
-   * @return A reference to the lhs object after assignment
-   */
-  Game_State &operator=(const Game_State &rhs);
+  /// @brief Castling rights, one bit each in Game_State::castling
+  enum Castling : uint8_t {
+    castle_w_K = 1, ///< white can castle king side
+    castle_w_Q = 2, ///< white can castle queen side
+    castle_b_k = 4, ///< black can castle king side
+    castle_b_q = 8, ///< black can castle queen side
+  };
 
   /// @return The the active color: w or b.
   [[nodiscard]] char fen_active_color() const {
@@ -74,20 +78,19 @@ struct Game_State {
    * Valid characters are 'K', 'Q', 'k', and 'q'.
    * @param s The input string representing the castling ability.
    */
-  void set_castling_ability(const std::string &s);
+  void set_castling_ability(std::string_view s);
+
+  /// @return True if the given castling right is still held
+  [[nodiscard]] bool can_castle(const Castling right) const {
+    return castling & right;
+  }
 
   // game-state data
-  Color active_color = Color::white; ///< who's turn is it anyway?
-  bool castle_w_K = true;            ///< white can castle king side
-  bool castle_w_Q = true;            ///< white can castle queen side
-  bool castle_b_k = true;            ///< black can castle king side
-  bool castle_b_q = true;            ///< black can castle queen side
-  std::string en_passant_target;     ///< en passant target
-  bool en_passant_set = false; ///< was an en passant target created this turn?
-  uint half_move_clock{};      ///< for the 50 move rule
-  uint full_move_number = 1;   ///< starts at 1, increments after black moves
-  bool black_inCheck = false;  ///< black king is in check
-  bool white_inCheck = false;  ///< white king is in check
+  Color active_color = Color::white;       ///< who's turn is it anyway?
+  Square en_passant_target = Square::none; ///< en passant target
+  uint16_t half_move_clock{};              ///< for the 50 move rule
+  uint16_t full_move_number = 1; ///< starts at 1, increments after black moves
+  uint8_t castling = castle_w_K | castle_w_Q | castle_b_k | castle_b_q;
 };
 
 #endif // INCLUDE_GAME_STATE_H_
@@ -0,0 +1,138 @@
+/*
+ *     ____              __          __          __
+ *    / __ \____ _____ _/ /_        / /_  ____  / /_
+ *   / /_/ / __ `/ __ `/ __ \______/ __ \/ __ \/ __/
+ *  / _, _/ /_/ / /_/ / /_/ /_____/ /_/ / /_/ / /_
+ * /_/ |_|\__,_/\__,_/_.___/     /_.___/\____/\__/
+ *
+ * Copyright (c) 2024 de-Manzanares
+ * This work is released under the MIT license.
+ *
+ */
+
+#ifndef INCLUDE_MOVE_H_
+#define INCLUDE_MOVE_H_
+
+#include "Square.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+/**
+ * @class Move
+ * @brief A move packed into 16 bits
+ * @details bits 0-5: from square \n
+ *          bits 6-11: to square \n
+ *          bits 12-15: flags; 4 marks a capture, 8 a promotion, in which case
+ *          the low two bits give the piece (knight, bishop, rook, queen)
+ */
+class Move {
+ public:
+  /// @brief Move flags, stored in the top four bits
+  enum Flag : uint16_t {
+    quiet = 0,
+    double_push = 1,
+    king_castle = 2,
+    queen_castle = 3,
+    capture = 4,
+    en_passant = 5,
+    promotion = 8, ///< + 0-3 for knight, bishop, rook, queen; + 4 if capturing
+  };
+
+  /// @brief Uninitialized, so that a MoveList costs nothing to create
+  Move() = default;
+
+  /**
+   * @param from The square the piece moves from
+   * @param to The square the piece moves to
+   * @param flags One of Move::Flag, promotions combined with the piece offset
+   * and Flag::capture
+   */
+  constexpr Move(const Square from, const Square to, const uint16_t flags = 0)
+      : _data(static_cast<uint16_t>(static_cast<uint16_t>(from) |
+                                    static_cast<uint16_t>(to) << 6 |
+                                    flags << 12)) {}
+
+  [[nodiscard]] constexpr Square from() const {
+    return static_cast<Square>(_data & 0x3F);
+  }
+  [[nodiscard]] constexpr Square to() const {
+    return static_cast<Square>(_data >> 6 & 0x3F);
+  }
+  [[nodiscard]] constexpr uint16_t flags() const { return _data >> 12; }
+  [[nodiscard]] constexpr bool is_capture() const { return flags() & capture; }
+  [[nodiscard]] constexpr bool is_promotion() const {
+    return flags() & promotion;
+  }
+  [[nodiscard]] constexpr bool is_castle() const {
+    return flags() == king_castle || flags() == queen_castle;
+  }
+
+  /// @return The piece to promote to ('n', 'b', 'r', 'q'), or 0
+  [[nodiscard]] constexpr char promotion_piece() const {
+    return is_promotion() ? "nbrq"[flags() & 3] : 0;
+  }
+
+  /// @return The move in long algebraic notation, e.g. e2e4 or e7e8q
+  [[nodiscard]] std::string uci() const {
+    std::string s = Sq::square_to_string(from()) + Sq::square_to_string(to());
+    if (is_promotion()) {
+      s += promotion_piece();
+    }
+    return s;
+  }
+
+  /// @return A move that is never legal, standing in for "no move"
+  static constexpr Move none() { return {Square::h1, Square::h1}; }
+
+  constexpr bool operator==(const Move &rhs) const = default;
+
+ private:
+  uint16_t _data;
+};
+
+/**
+ * @enum Gen_Type
+ * @brief Which moves a generator produces
+ * @details Captures and quiets split the legal moves between them. Every
+ * promotion counts as a capture, and castling as a quiet move. Evasions are
+ * for a side in check: king moves, and in single check the moves that
+ * capture the checker or block it.
+ */
+enum class Gen_Type {
+  all,      ///< every legal move
+  captures, ///< captures, en passant and promotions
+  quiets,   ///< everything else
+  evasions  ///< moves that may answer a check; only valid when in check
+};
+
+/**
+ * @class MoveList
+ * @brief A fixed-capacity list of moves that lives on the stack
+ * @note 256 is more than the number of legal moves in any chess position.
+ */
+class MoveList {
+ public:
+  static constexpr unsigned CAPACITY = 256; ///< maximum number of moves
+
+  void push_back(const Move m) { _moves[_size++] = m; }
+  void clear() { _size = 0; }
+
+  [[nodiscard]] unsigned size() const { return _size; }
+  [[nodiscard]] bool empty() const { return _size == 0; }
+
+  Move &operator[](const unsigned i) { return _moves[i]; }
+  const Move &operator[](const unsigned i) const { return _moves[i]; }
+
+  Move *begin() { return _moves.data(); }
+  Move *end() { return _moves.data() + _size; }
+  [[nodiscard]] const Move *begin() const { return _moves.data(); }
+  [[nodiscard]] const Move *end() const { return _moves.data() + _size; }
+
+ private:
+  std::array<Move, CAPACITY> _moves;
+  unsigned _size = 0;
+};
+
+#endif // INCLUDE_MOVE_H_
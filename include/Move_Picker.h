@@ -0,0 +1,90 @@
+/*
+ *     ____              __          __          __
+ *    / __ \____ _____ _/ /_        / /_  ____  / /_
+ *   / /_/ / __ `/ __ `/ __ \______/ __ \/ __ \/ __/
+ *  / _, _/ /_/ / /_/ / /_/ /_____/ /_/ / /_/ / /_
+ * /_/ |_|\__,_/\__,_/_.___/     /_.___/\____/\__/
+ *
+ * Copyright (c) 2024 de-Manzanares
+ * This work is released under the MIT license.
+ *
+ */
+
+#ifndef INCLUDE_MOVE_PICKER_H_
+#define INCLUDE_MOVE_PICKER_H_
+
+#include "Board.h"
+
+#include <array>
+
+/**
+ * @class Move_Picker
+ * @brief Hands out the legal moves of a position one at a time, likeliest
+ * best first, generating each group only when it is reached
+ * @details The order is the hash move, captures by most valuable victim then
+ * least valuable attacker, the killer moves, the remaining quiet moves, then
+ * the captures that lose material by static exchange evaluation. In check,
+ * the hash move is followed by the evasions, captures first.
+ * A search that cuts off on the hash move or a capture never generates the
+ * quiet moves at all. Moves are generated pseudo-legal and checked with
+ * Board::is_legal only as they are handed out. The hash move and killers come
+ * from the caller and are only played if they are legal in this position, so
+ * stale ones are harmless.
+ */
+class Move_Picker {
+ public:
+  /**
+   * @param board The position to pick moves in; must outlive the picker
+   * @param hash_move The best move found here before, or Move::none()
+   * @param killers Quiet moves that caused cutoffs at the same ply elsewhere
+   */
+  explicit Move_Picker(const Board &board, Move hash_move = Move::none(),
+                       std::array<Move, 2> killers = {Move::none(),
+                                                      Move::none()});
+
+  /// @return The next move, or Move::none() once every move has been given
+  Move next();
+
+ private:
+  enum class Stage {
+    hash,
+    captures_init,
+    captures,
+    killers,
+    quiets,
+    bad_captures,
+    evasions,
+    done
+  };
+
+  /// @return The captures and promotions, or the evasions when in check,
+  /// generated on first use
+  const MoveList &captures();
+
+  /// @return The quiet moves, generated on first use
+  const MoveList &quiets();
+
+  /// @return The best scoring move left in _captures, moved to _index
+  Move pick_best();
+
+  /// @return The MVV-LVA score of a capture or promotion
+  [[nodiscard]] int score(Move move) const;
+
+  /// @return True if the move was already given out ahead of its group
+  [[nodiscard]] bool given_early(Move move) const;
+
+  const Board &_board;                           ///< position being searched
+  Check_Info _info;                              ///< pins and checks in it
+  Move _hash_move;                               ///< tried first if legal
+  std::array<Move, 2> _killers;                  ///< tried after captures
+  Stage _stage = Stage::hash;                    ///< group being handed out
+  unsigned _index = 0;                           ///< next entry of the group
+  bool _have_captures = false;                   ///< _captures is generated
+  bool _have_quiets = false;                     ///< _quiets is generated
+  MoveList _captures;                            ///< captures or evasions
+  MoveList _quiets;                              ///< everything else
+  MoveList _bad_captures;                        ///< captures that lose
+  std::array<int, MoveList::CAPACITY> _scores{}; ///< one per capture
+};
+
+#endif // INCLUDE_MOVE_PICKER_H_
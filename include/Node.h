@@ -48,12 +48,11 @@ class Node : std::enable_shared_from_this<Node> {
 
   /**
    * @brief Constructor used in tree generation
-   * @param board The board to be copied.
-   * @param from The starting square of the move to be made.
-   * @param to The ending square of the move to be made.
-   * @param ch If the move is a pawn promotion, the character to promote to.
+   * @details The node has no board of its own. While it is being expanded it
+   * shares the root's board, which has the move made on it.
+   * @param move The move that leads to this node
    */
-  Node(const std::shared_ptr<Board> &board, Square from, Square to, char ch);
+  explicit Node(Move move);
 
   auto from() -> Square & { return _from; }
   auto from() const -> Square const & { return _from; }
@@ -73,8 +72,10 @@ class Node : std::enable_shared_from_this<Node> {
    * @brief Creates a decision tree of n layers.
    * @details Uses a depth-first recursive algorithm
    * @param depth The depth of the tree to spawn child nodes for.
-   * @note Resets (deletes) boards as additional layers are spawned. Don't try
-   * to access boards after creating the tree: they won't be there.
+   * @note Walks the tree on a single board, making a move before expanding a
+   * child and taking it back afterward. Nodes let go of the board once they
+   * are expanded: don't try to access boards after creating the tree, they
+   * won't be there.
    */
   void spawn_depth_first(uint depth);
 
@@ -0,0 +1,120 @@
+/*
+ *     ____              __          __          __
+ *    / __ \____ _____ _/ /_        / /_  ____  / /_
+ *   / /_/ / __ `/ __ `/ __ \______/ __ \/ __ \/ __/
+ *  / _, _/ /_/ / /_/ / /_/ /_____/ /_/ / /_/ / /_
+ * /_/ |_|\__,_/\__,_/_.___/     /_.___/\____/\__/
+ *
+ * Copyright (c) 2024 de-Manzanares
+ * This work is released under the MIT license.
+ *
+ */
+
+#ifndef INCLUDE_PERFT_H_
+#define INCLUDE_PERFT_H_
+
+#include "Board.h"
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+/**
+ * @class Perft_Table
+ * @brief A fixed-size table of subtree counts, shared by every perft thread
+ * @details Entries are keyed by the Zobrist key of a position and the depth
+ * counted below it. Each entry stores the count and the key XOR the count, so
+ * an entry torn by two threads writing at once fails the check on the next
+ * probe instead of giving a wrong count, and no locks are needed.
+ */
+class Perft_Table {
+ public:
+  /// @param megabytes The size of the table, rounded down to a power of two
+  explicit Perft_Table(std::size_t megabytes);
+
+  /**
+   * @brief Look up the count of a subtree
+   * @param key The Zobrist key of the position at the top of the subtree
+   * @param depth The depth counted below it
+   * @param nodes Set to the count if it is found
+   * @return True if the count was found
+   */
+  bool probe(uint64_t key, uint depth, uint64_t *nodes) const;
+
+  /// @brief Remember the count of a subtree, replacing whatever was there
+  void store(uint64_t key, uint depth, uint64_t nodes);
+
+  /// @brief Add a thread's probe and hit counts to the totals
+  void record(uint64_t probes, uint64_t hits);
+
+  /// @return The share of probes that were hits, from 0 to 1
+  [[nodiscard]] double hit_rate() const;
+
+  /// @return The number of entries in the table
+  [[nodiscard]] std::size_t size() const { return _entries.size(); }
+
+ private:
+  struct Entry {
+    std::atomic<uint64_t> check; ///< key and depth, XOR nodes
+    std::atomic<uint64_t> nodes; ///< leaf nodes in the subtree
+  };
+
+  /// @return The key of a position combined with a depth
+  static uint64_t lock(uint64_t key, uint depth);
+
+  std::vector<Entry> _entries;
+  std::atomic<uint64_t> _probes{}; ///< lookups at depth 2 and beyond
+  std::atomic<uint64_t> _hits{};   ///< lookups that found a count
+};
+
+/**
+ * @struct Perft
+ * @brief Counts the leaf nodes of the legal move tree, for checking and timing
+ * move generation
+ * @details Published counts exist for many positions, so a mismatch points to
+ * a move generator bug, and divide narrows it down to a root move.
+ */
+struct Perft {
+  /**
+   * @brief Count the leaf nodes at a given depth
+   * @details The last ply is bulk counted: the number of legal moves is the
+   * number of leaves, so those moves are never made, or even written out.
+   * @param board The position to count from, restored before returning
+   * @param depth The number of plies to look ahead
+   * @param table If given, subtree counts are looked up and stored here
+   * @return The number of leaf nodes
+   */
+  static uint64_t count(Board &board, uint depth,
+                        Perft_Table *table = nullptr);
+
+  /**
+   * @brief Count the leaf nodes at a given depth on several threads
+   * @details The tree is split into subtrees, starting with the root moves and
+   * going one ply deeper while there are too few to keep every thread busy.
+   * Each worker counts the subtrees it takes on its own copy of the board.
+   * @param board The position to count from
+   * @param depth The number of plies to look ahead
+   * @param threads The number of worker threads
+   * @param table If given, subtree counts are shared between the threads here
+   * @return The number of leaf nodes
+   */
+  static uint64_t count(const Board &board, uint depth, uint threads,
+                        Perft_Table *table = nullptr);
+
+  /**
+   * @brief Count the leaf nodes below each root move, then the total
+   * @details Prints one "move: nodes" line per legal move, then the total,
+   * the elapsed time, the nodes per second and the hash table hit rate.
+   * @param board The position to count from, restored before returning
+   * @param depth The number of plies to look ahead, at least 1
+   * @param out Where to print the results
+   * @param threads The number of worker threads
+   * @param table If given, subtree counts are shared between the threads here
+   * @return The number of leaf nodes
+   */
+  static uint64_t divide(Board &board, uint depth, std::ostream &out,
+                         uint threads = 1, Perft_Table *table = nullptr);
+};
+
+#endif // INCLUDE_PERFT_H_
@@ -31,7 +31,8 @@
  *   - ...
  *   - From h8 to a8
  *
- * The values of the squares are consecutive integers from 0 to 63.
+ * The values of the squares are consecutive integers from 0 to 63. Square::none
+ * (64) stands for "no square", e.g. when there is no en passant target.
  */
 // clang-format off
 enum class Square : int {
@@ -43,6 +44,7 @@ enum class Square : int {
     h6, g6, f6, e6, d6, c6, b6, a6,
     h7, g7, f7, e7, d7, c7, b7, a7,
     h8, g8, f8, e8, d8, c8, b8, a8,
+    none
 };
 // clang-format on
 
@@ -103,6 +105,12 @@ enum class Color { white, black, none };
  */
 Color &operator!(Color &color); // NOLINT
 
+/**
+ * @enum Piece
+ * @brief Kind of a piece, regardless of its color
+ */
+enum class Piece { pawn, knight, bishop, rook, queen, king, none };
+
 /**
  * @struct Sq
  * @brief For converting between string representations and enum values of
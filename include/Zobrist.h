@@ -0,0 +1,74 @@
+/*
+ *     ____              __          __          __
+ *    / __ \____ _____ _/ /_        / /_  ____  / /_
+ *   / /_/ / __ `/ __ `/ __ \______/ __ \/ __ \/ __/
+ *  / _, _/ /_/ / /_/ / /_/ /_____/ /_/ / /_/ / /_
+ * /_/ |_|\__,_/\__,_/_.___/     /_.___/\____/\__/
+ *
+ * Copyright (c) 2024 de-Manzanares
+ * This work is released under the MIT license.
+ *
+ */
+
+#ifndef INCLUDE_ZOBRIST_H_
+#define INCLUDE_ZOBRIST_H_
+
+#include <array>
+#include <cstdint>
+
+/**
+ * @namespace zobrist
+ * @brief Random keys whose XOR identifies a position
+ * @details A position's key is the XOR of the key of every piece on its square,
+ * the key of the castling rights, the key of the en passant file if there is a
+ * target, and the side key if black is to move. Making a move only has to XOR
+ * out what changed and XOR in what replaced it.
+ */
+namespace zobrist {
+
+/// @return A well mixed 64-bit number for each n (SplitMix64)
+constexpr uint64_t mix(uint64_t n) {
+  n = (n + 1) * 0x9E3779B97F4A7C15ULL;
+  n = (n ^ (n >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  n = (n ^ (n >> 27)) * 0x94D049BB133111EBULL;
+  return n ^ (n >> 31);
+}
+
+/// key of each piece on each square, indexed by mailbox code; empty is 0
+constexpr std::array<std::array<uint64_t, 64>, 13> piece = [] {
+  std::array<std::array<uint64_t, 64>, 13> table{};
+  for (int code = 1; code < 13; ++code) {
+    for (int sq = 0; sq < 64; ++sq) {
+      table[code][sq] = mix(code * 64 + sq);
+    }
+  }
+  return table;
+}();
+
+/// key of each combination of castling rights, no rights is 0
+constexpr std::array<uint64_t, 16> castling = [] {
+  std::array<uint64_t, 16> table{};
+  for (int rights = 0; rights < 16; ++rights) {
+    for (int i = 0; i < 4; ++i) {
+      if (rights & 1 << i) {
+        table[rights] ^= mix(13 * 64 + i);
+      }
+    }
+  }
+  return table;
+}();
+
+/// key of the file of the en passant target, indexed by Geometry::file
+constexpr std::array<uint64_t, 8> en_passant = [] {
+  std::array<uint64_t, 8> table{};
+  for (int file = 0; file < 8; ++file) {
+    table[file] = mix(13 * 64 + 4 + file);
+  }
+  return table;
+}();
+
+constexpr uint64_t side = mix(13 * 64 + 12); ///< black to move
+
+} // namespace zobrist
+
+#endif // INCLUDE_ZOBRIST_H_
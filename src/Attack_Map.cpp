@@ -0,0 +1,97 @@
+/*
+ *     ____              __          __          __
+ *    / __ \____ _____ _/ /_        / /_  ____  / /_
+ *   / /_/ / __ `/ __ `/ __ \______/ __ \/ __ \/ __/
+ *  / _, _/ /_/ / /_/ / /_/ /_____/ /_/ / /_/ / /_
+ * /_/ |_|\__,_/\__,_/_.___/     /_.___/\____/\__/
+ *
+ * Copyright (c) 2024 de-Manzanares
+ * This work is released under the MIT license.
+ *
+ */
+
+#include "Attack_Map.h"
+
+Attack_Map::Attack_Map(const Board &board) {
+  _owner.fill(Color::none);
+  for (uint64_t b = board.occupied(); b;) {
+    const Square sq = bitboard::pop_lsb(b);
+    set(sq, board.what_color(sq), piece_attacks(board, sq));
+  }
+  _occupied = board.by_color;
+  for (const Color c : {Color::white, Color::black}) {
+    _kings[static_cast<int>(c)] = board.pieces(c, Piece::king);
+  }
+}
+
+uint64_t Attack_Map::piece_attacks(const Board &board, const Square sq) {
+  const int i = static_cast<int>(sq);
+  switch (board.piece_on(sq)) {
+  case Piece::pawn:
+    return Attacks::pawn[static_cast<int>(board.what_color(sq))][i];
+  case Piece::knight:
+    return Attacks::knight[i];
+  case Piece::bishop:
+    return Attacks::bishop(sq, board.occupied());
+  case Piece::rook:
+    return Attacks::rook(sq, board.occupied());
+  case Piece::queen:
+    return Attacks::queen(sq, board.occupied());
+  case Piece::king:
+    return Attacks::king[i];
+  case Piece::none:
+    break;
+  }
+  return 0;
+}
+
+void Attack_Map::set(const Square sq, const Color c, const uint64_t attacks) {
+  const int i = static_cast<int>(sq);
+  if (_owner[i] != Color::none) {
+    const int old = static_cast<int>(_owner[i]);
+    for (uint64_t b = _from[i]; b;) {
+      const int to = static_cast<int>(bitboard::pop_lsb(b));
+      if (--_count[old][to] == 0) {
+        _by_color[old] &= ~(1ULL << to);
+      }
+    }
+  }
+  _from[i] = attacks;
+  _owner[i] = c;
+  if (c != Color::none) {
+    const int now = static_cast<int>(c);
+    for (uint64_t b = attacks; b;) {
+      const int to = static_cast<int>(bitboard::pop_lsb(b));
+      ++_count[now][to];
+      _by_color[now] |= 1ULL << to;
+    }
+  }
+}
+
+void Attack_Map::update(const Board &board) {
+  // a move always empties or fills a square, or changes its color, on every
+  // square whose contents it changes
+  const uint64_t changed = (_occupied[0] ^ board.by_color[0]) |
+                           (_occupied[1] ^ board.by_color[1]);
+
+  // sliders whose rays reached a changed square may now stop sooner or go
+  // further
+  const uint64_t sliders = board.by_piece[static_cast<int>(Piece::bishop)] |
+                           board.by_piece[static_cast<int>(Piece::rook)] |
+                           board.by_piece[static_cast<int>(Piece::queen)];
+  for (uint64_t b = sliders & ~changed; b;) {
+    const Square sq = bitboard::pop_lsb(b);
+    if (_from[static_cast<int>(sq)] & changed) {
+      set(sq, board.what_color(sq), piece_attacks(board, sq));
+    }
+  }
+  for (uint64_t b = changed; b;) {
+    const Square sq = bitboard::pop_lsb(b);
+    set(sq, board.what_color(sq), piece_attacks(board, sq));
+  }
+
+  _occupied = board.by_color;
+  for (const Color c : {Color::white, Color::black}) {
+    _kings[static_cast<int>(c)] = board.pieces(c, Piece::king);
+  }
+}
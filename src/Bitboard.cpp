@@ -0,0 +1,220 @@
+/*
+ *     ____              __          __          __
+ *    / __ \____ _____ _/ /_        / /_  ____  / /_
+ *   / /_/ / __ `/ __ `/ __ \______/ __ \/ __ \/ __/
+ *  / _, _/ /_/ / /_/ / /_/ /_____/ /_/ / /_/ / /_
+ * /_/ |_|\__,_/\__,_/_.___/     /_.___/\____/\__/
+ *
+ * Copyright (c) 2024 de-Manzanares
+ * This work is released under the MIT license.
+ *
+ */
+
+#include "Bitboard.h"
+
+#if defined(RAAB_BOT_X86_64) && defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(RAAB_BOT_X86_64)
+#include <cpuid.h>
+#endif
+
+std::array<Magic, 64> Attacks::rook_magics{};
+std::array<Magic, 64> Attacks::bishop_magics{};
+Slider_Backend Attacks::backend = Slider_Backend::magic;
+
+#if defined(RAAB_BOT_X86_64) && !defined(__BMI2__) && !defined(_MSC_VER)
+// compiled for BMI2 on its own, only reached once CPUID has reported it
+__attribute__((target("bmi2"))) uint64_t bitboard::pext(const uint64_t b,
+                                                        const uint64_t mask) {
+  return _pext_u64(b, mask);
+}
+#elif !defined(RAAB_BOT_X86_64)
+uint64_t bitboard::pext(uint64_t b, uint64_t mask) { // portable fallback
+  uint64_t result = 0;
+  for (uint64_t bit = 1; mask; bit <<= 1) {
+    if (b & mask & (~mask + 1)) {
+      result |= bit;
+    }
+    mask &= mask - 1;
+  }
+  return result;
+}
+#endif
+
+namespace init_magics {
+
+std::array<uint64_t, 0x19000> rook_table{};  ///< all rook attack sets
+std::array<uint64_t, 0x1480> bishop_table{}; ///< all bishop attack sets
+
+constexpr std::array<std::array<int, 2>, 4> rook_directions{
+    {{0, 1}, {0, -1}, {1, 0}, {-1, 0}}};
+constexpr std::array<std::array<int, 2>, 4> bishop_directions{
+    {{1, 1}, {-1, 1}, {1, -1}, {-1, -1}}};
+
+/**
+ * @brief Walk each ray square by square until it leaves the board or hits a
+ * blocker
+ * @return The attack set, stored in the table for every blocker subset
+ */
+uint64_t sliding_attack(const std::array<std::array<int, 2>, 4> &directions,
+                        const Square sq, const uint64_t occupied) {
+  uint64_t attack = 0;
+  for (const auto &[files, ranks] : directions) {
+    uint64_t b = bitboard::square(sq);
+    while ((b = bitboard::shift(b, files, ranks))) {
+      attack |= b;
+      if (b & occupied) {
+        break;
+      }
+    }
+  }
+  return attack;
+}
+
+// Found offline with a random sparse search. Squares run h1..a8, so these
+// differ from the magics published for a1..h8 boards.
+
+/// rook magic for each square
+constexpr std::array<uint64_t, 64> rook_numbers{
+    0x0A80004000801220ULL, 0x10C0100040002000ULL, 0x0100102000410009ULL,
+    0x0B0021000C100008ULL, 0x4080080080040002ULL, 0x0200019004080200ULL,
+    0x0400080A10112684ULL, 0x20800A4D00062080ULL, 0x2091800020804000ULL,
+    0x0044401000200040ULL, 0x1001002000401108ULL, 0x1001800801100081ULL,
+    0x0001000500080010ULL, 0x1000808002000400ULL, 0x0404000482100108ULL,
+    0x0003000182610002ULL, 0x0440848002C00420ULL, 0x2010890040010021ULL,
+    0x8800110020044300ULL, 0x0208010100201000ULL, 0x1222020004102008ULL,
+    0x0000808002000400ULL, 0x20040400094A9008ULL, 0x0000420000804401ULL,
+    0x0040002880004680ULL, 0x0000200240100040ULL, 0x0020008180201001ULL,
+    0x01080080800C1000ULL, 0x0104040080800800ULL, 0x4800020080040080ULL,
+    0x0002000200840108ULL, 0x00A1000100006082ULL, 0x8004400088800260ULL,
+    0x0100804000802008ULL, 0x0010008010802002ULL, 0x000C801000800800ULL,
+    0x0C51800402800800ULL, 0x0002800200800400ULL, 0x0000820804000110ULL,
+    0x4003808042000401ULL, 0x00208020C0018000ULL, 0x4400402010004009ULL,
+    0x22100400A800E000ULL, 0x0E020021400A0013ULL, 0x10A0080100110005ULL,
+    0x0004010002004040ULL, 0x0024080102040010ULL, 0x4154089108420014ULL,
+    0x0182400080002380ULL, 0x0000400110802100ULL, 0x0000100080200480ULL,
+    0x100A000820401200ULL, 0x8081004020801002ULL, 0x0002000408100200ULL,
+    0x03223A1008010C00ULL, 0x000000831C014200ULL, 0x4200208009001041ULL,
+    0xC001004000881021ULL, 0x1008200100100841ULL, 0x0000082240920032ULL,
+    0x4002000804201102ULL, 0xB821000804000201ULL, 0x4080C208102100A4ULL,
+    0x02020900418C0CA2ULL,
+};
+
+/// bishop magic for each square
+constexpr std::array<uint64_t, 64> bishop_numbers{
+    0x40106000A1160020ULL, 0x0230106090808800ULL, 0x4010210041000800ULL,
+    0x02240400980C2000ULL, 0x1304030800402088ULL, 0x140A0F1008000002ULL,
+    0x0001043002088080ULL, 0x0431240044102800ULL, 0x0000400222021200ULL,
+    0x0040080880809206ULL, 0x0420044104250001ULL, 0x0008841046010A40ULL,
+    0x2000020210001000ULL, 0x4000C20190080000ULL, 0x0404020801041004ULL,
+    0x0004004048241040ULL, 0x8008802002104A20ULL, 0x08080802B0840080ULL,
+    0x1008082A42040020ULL, 0x2118010402142012ULL, 0x2002800400A08004ULL,
+    0x2108080082012020ULL, 0x2054038069080800ULL, 0x0000400202020110ULL,
+    0x0230404825040481ULL, 0x1030310108012102ULL, 0x8808020A11140105ULL,
+    0x0014040038020808ULL, 0x2084040018410040ULL, 0x8409420001C11030ULL,
+    0x000088904C020830ULL, 0x00032A0401420080ULL, 0xA204824014602422ULL,
+    0xC9021A1308E00824ULL, 0x0404020100420400ULL, 0x2800600800048820ULL,
+    0x00084A0020120080ULL, 0x00041000800C1040ULL, 0x2004081880004400ULL,
+    0x0042040031250091ULL, 0xC20A082008004400ULL, 0x1124010882122800ULL,
+    0x8842010101002081ULL, 0x4001044200808808ULL, 0x0000240102122400ULL,
+    0x3082240806020221ULL, 0x803010B218808040ULL, 0x1034A40400400020ULL,
+    0x4081040120690000ULL, 0x00420A12090C8500ULL, 0x0808420124090940ULL,
+    0x1110050042020001ULL, 0x0D60224099024000ULL, 0x0100084218820081ULL,
+    0x08882048088504A8ULL, 0x2406088F01060390ULL, 0x000202010C829000ULL,
+    0x0260010421010810ULL, 0x0004200A004208A0ULL, 0x0222000800208821ULL,
+    0x0083040004104421ULL, 0x2011808810100224ULL, 0x2102A02002208100ULL,
+    0x0002420441020602ULL,
+};
+
+/**
+ * @brief Fill in the mask, magic and table slice of every square
+ * @param directions The directions the slider moves in
+ * @param numbers The magic number for each square
+ * @param table Storage for the attack sets of all squares
+ * @param magics The magics to fill in
+ */
+void init(const std::array<std::array<int, 2>, 4> &directions,
+          const std::array<uint64_t, 64> &numbers, uint64_t *table,
+          std::array<Magic, 64> &magics) {
+  for (int i = 0; i < 64; ++i) {
+    const auto sq = static_cast<Square>(i);
+    Magic &m = magics[i];
+
+    // the edges only matter when the slider is on them
+    const uint64_t edges =
+        ((bitboard::RANK_1 | bitboard::RANK_8) &
+         ~(bitboard::RANK_1 << (8 * (i / 8)))) |
+        ((bitboard::FILE_A | bitboard::FILE_H) &
+         ~(bitboard::FILE_H << (i % 8)));
+
+    m.mask = sliding_attack(directions, sq, 0) & ~edges;
+    m.magic = numbers[i];
+    m.shift = 64 - bitboard::count(m.mask);
+    m.attacks = i == 0 ? table
+                       : magics[i - 1].attacks +
+                             (1ULL << (64 - magics[i - 1].shift));
+
+    // store the attack set of every subset of the mask (Carry-Rippler)
+    uint64_t b = 0;
+    do {
+      m.attacks[Attacks::index(m, b)] = sliding_attack(directions, sq, b);
+      b = (b - m.mask) & m.mask;
+    } while (b);
+  }
+}
+
+} // namespace init_magics
+
+bool Attacks::has_fast_pext() {
+#if defined(RAAB_BOT_X86_64)
+  unsigned regs[4]{}; // eax, ebx, ecx, edx
+  const auto cpuid = [&regs](const unsigned leaf) {
+#if defined(_MSC_VER)
+    int r[4];
+    __cpuidex(r, static_cast<int>(leaf), 0);
+    for (int i = 0; i < 4; ++i) {
+      regs[i] = static_cast<unsigned>(r[i]);
+    }
+#else
+    __cpuid_count(leaf, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+  };
+
+  cpuid(0);
+  const unsigned max_leaf = regs[0];
+  const bool amd = regs[1] == 0x68747541; // "Auth" of "AuthenticAMD"
+  if (max_leaf < 7) {
+    return false;
+  }
+  cpuid(7);
+  if (!(regs[1] & (1U << 8))) { // BMI2
+    return false;
+  }
+  cpuid(1);
+  const unsigned family = ((regs[0] >> 8) & 0xF) + ((regs[0] >> 20) & 0xFF);
+  return !amd || family >= 0x19; // Zen 3 and later
+#else
+  return false;
+#endif
+}
+
+const char *Attacks::backend_name() {
+  return backend == Slider_Backend::pext ? "pext" : "magic";
+}
+
+void Attacks::init(const Slider_Backend b) {
+  backend = b;
+  init_magics::init(init_magics::rook_directions, init_magics::rook_numbers,
+                    init_magics::rook_table.data(), rook_magics);
+  init_magics::init(init_magics::bishop_directions,
+                    init_magics::bishop_numbers,
+                    init_magics::bishop_table.data(), bishop_magics);
+}
+
+namespace init_magics {
+/// builds the tables before main() so lookups never need to check for them
+[[maybe_unused]] const bool initialized =
+    (Attacks::init(Attacks::has_fast_pext() ? Slider_Backend::pext
+                                            : Slider_Backend::magic),
+     true);
+} // namespace init_magics
@@ -13,37 +13,15 @@
 #include "Board.h"
 
 #include <algorithm>
+#include <cassert>
+#include <cctype>
+#include <charconv>
+#include <cstring>
 #include <ranges>
-#include <sstream>
 
 using s = Square;
 using c = Color;
 
-std::vector<std::vector<Square>> Diagonals::leftRight = {
-    {s::a6, s::b7, s::c8},
-    {s::a5, s::b6, s::c7, s::d8},
-    {s::a4, s::b5, s::c6, s::d7, s::e8},
-    {s::a3, s::b4, s::c5, s::d6, s::e7, s::f8},
-    {s::a2, s::b3, s::c4, s::d5, s::e6, s::f7, s::g8},
-    {s::a1, s::b2, s::c3, s::d4, s::e5, s::f6, s::g7, s::h8},
-    {s::b1, s::c2, s::d3, s::e4, s::f5, s::g6, s::h7},
-    {s::c1, s::d2, s::e3, s::f4, s::g5, s::h6},
-    {s::d1, s::e2, s::f3, s::g4, s::h5},
-    {s::e1, s::f2, s::g3, s::h4},
-    {s::f1, s::g2, s::h3}};
-std::vector<std::vector<Square>> Diagonals::rightLeft = {
-    {s::h6, s::g7, s::f8},
-    {s::h5, s::g6, s::f7, s::e8},
-    {s::h4, s::g5, s::f6, s::e7, s::d8},
-    {s::h3, s::g4, s::f5, s::e6, s::d7, s::c8},
-    {s::h2, s::g3, s::f4, s::e5, s::d6, s::c7, s::b8},
-    {s::h1, s::g2, s::f3, s::e4, s::d5, s::c6, s::b7, s::a8},
-    {s::g1, s::f2, s::e3, s::d4, s::c5, s::b6, s::a7},
-    {s::f1, s::e2, s::d3, s::c4, s::b5, s::a6},
-    {s::e1, s::d2, s::c3, s::b4, s::a5},
-    {s::d1, s::c2, s::b3, s::a4},
-    {s::c1, s::b2, s::a3}};
-
 //------------------------------------------------------------------------------
 // BEGIN Boundary detection
 
@@ -64,77 +42,79 @@ bool is_right_horizontal_boundary(const Square sq) {
 // END Boundary detection
 //------------------------------------------------------------------------------
 
-void Maps::clear() {
-  white_influence.clear();
-  black_influence.clear();
-  white_pinned.clear();
-  black_pinned.clear();
-  white_moves.clear();
-  black_moves.clear();
+void Board::clear() {
+  // remove all the pieces
+  by_piece.fill(0);
+  by_color.fill(0);
+  mailbox.fill(0);
+  // clear the game state
+  game_state.clear();
+  key = compute_key();
 }
 
-Board::~Board() { delete maps; }
-
-Board &Board::operator=(const Board &rhs) {
-  if (this != &rhs) {
-    b_pawn = rhs.b_pawn;
-    b_night = rhs.b_night;
-    b_bishop = rhs.b_bishop;
-    b_rook = rhs.b_rook;
-    b_queen = rhs.b_queen;
-    b_king = rhs.b_king;
-    w_Pawn = rhs.w_Pawn;
-    w_Night = rhs.w_Night;
-    w_Bishop = rhs.w_Bishop;
-    w_Rook = rhs.w_Rook;
-    w_Queen = rhs.w_Queen;
-    w_King = rhs.w_King;
-    game_state = rhs.game_state;
+uint64_t Board::compute_key() const {
+  uint64_t k = state_key();
+  for (int sq = 0; sq < 64; ++sq) {
+    k ^= zobrist::piece[mailbox_code(static_cast<Square>(sq))][sq];
   }
-  return *this;
+  return k;
 }
 
-void Board::clear() {
-  // remove all the pieces
-  b_pawn = b_night = b_bishop = b_rook = b_queen = b_king = 0;
-  w_Pawn = w_Night = w_Bishop = w_Rook = w_Queen = w_King = 0;
-  // clear the game state
-  game_state.clear();
+uint64_t Board::state_key() const {
+  uint64_t k = zobrist::castling[game_state.castling];
+  if (game_state.en_passant_target != Square::none) {
+    k ^= zobrist::en_passant
+        [Geometry::file[static_cast<int>(game_state.en_passant_target)]];
+  }
+  if (game_state.active_color == Color::black) {
+    k ^= zobrist::side;
+  }
+  return k;
 }
 
 void Board::remove_piece(Square square) {
-  const uint64_t mask = ~(1ULL << static_cast<uint>(square));
-  for (auto &bits : piece_map | std::views::values) {
-    bits &= mask;
+  const int code = mailbox_code(square);
+  if (code == 0) {
+    return;
   }
+  const uint64_t mask = ~bitboard::square(square);
+  key ^= zobrist::piece[code][static_cast<int>(square)];
+  by_piece[(code - 1) % 6] &= mask;
+  by_color[(code - 1) / 6] &= mask;
+  mailbox[static_cast<int>(square) / 2] &=
+      static_cast<uint8_t>(0xF0 >> (static_cast<int>(square) % 2 * 4));
 }
 
-void Board::place_piece(Square square, const char &ch) const {
-  for (const auto &[fst, snd] : piece_map) {
-    if (ch == fst) {
-      snd |= 1ULL << static_cast<uint>(square);
-    }
+void Board::place_piece(Square square, const char &ch) {
+  const char *found = std::strchr(PIECE_CHARS + 1, ch);
+  if (ch == '\0' || found == nullptr) {
+    return;
   }
+  place_code(square, static_cast<int>(found - PIECE_CHARS));
+}
+
+void Board::place_code(const Square square, const int code) {
+  const uint64_t b = bitboard::square(square);
+  key ^= zobrist::piece[code][static_cast<int>(square)];
+  by_piece[(code - 1) % 6] |= b;
+  by_color[(code - 1) / 6] |= b;
+  mailbox[static_cast<int>(square) / 2] |=
+      static_cast<uint8_t>(code << (static_cast<int>(square) % 2 * 4));
 }
 
 //------------------------------------------------------------------------------
 // BEGIN piece detection
 
 char Board::what_piece(Square sq) const {
-  for (const auto &[key, value] : piece_map) {
-    if (value & 1ULL << static_cast<int>(sq)) {
-      return key;
-    }
-  }
-  return ' ';
+  return PIECE_CHARS[mailbox_code(sq)];
 }
 
 bool Board::is_white_rook(Square sq) const {
-  return w_Rook & 1ULL << static_cast<int>(sq);
+  return pieces(c::white, Piece::rook) & 1ULL << static_cast<int>(sq);
 }
 
 bool Board::is_black_rook(Square sq) const {
-  return b_rook & 1ULL << static_cast<int>(sq);
+  return pieces(c::black, Piece::rook) & 1ULL << static_cast<int>(sq);
 }
 
 bool Board::is_rook(const Square sq) const {
@@ -142,11 +122,11 @@ bool Board::is_rook(const Square sq) const {
 }
 
 bool Board::is_white_bishop(Square sq) const {
-  return w_Bishop & 1ULL << static_cast<int>(sq);
+  return pieces(c::white, Piece::bishop) & 1ULL << static_cast<int>(sq);
 }
 
 bool Board::is_black_bishop(Square sq) const {
-  return b_bishop & 1ULL << static_cast<int>(sq);
+  return pieces(c::black, Piece::bishop) & 1ULL << static_cast<int>(sq);
 }
 
 bool Board::is_bishop(const Square sq) const {
@@ -154,11 +134,11 @@ bool Board::is_bishop(const Square sq) const {
 }
 
 bool Board::is_white_queen(Square sq) const {
-  return w_Queen & 1ULL << static_cast<int>(sq);
+  return pieces(c::white, Piece::queen) & 1ULL << static_cast<int>(sq);
 }
 
 bool Board::is_black_queen(Square sq) const {
-  return b_queen & 1ULL << static_cast<int>(sq);
+  return pieces(c::black, Piece::queen) & 1ULL << static_cast<int>(sq);
 }
 
 bool Board::is_queen(const Square sq) const {
@@ -166,11 +146,11 @@ bool Board::is_queen(const Square sq) const {
 }
 
 bool Board::is_white_knight(Square sq) const {
-  return w_Night & 1ULL << static_cast<int>(sq);
+  return pieces(c::white, Piece::knight) & 1ULL << static_cast<int>(sq);
 }
 
 bool Board::is_black_knight(Square sq) const {
-  return b_night & 1ULL << static_cast<int>(sq);
+  return pieces(c::black, Piece::knight) & 1ULL << static_cast<int>(sq);
 }
 
 bool Board::is_knight(const Square sq) const {
@@ -178,11 +158,11 @@ bool Board::is_knight(const Square sq) const {
 }
 
 bool Board::is_white_king(Square sq) const {
-  return w_King & 1ULL << static_cast<int>(sq);
+  return pieces(c::white, Piece::king) & 1ULL << static_cast<int>(sq);
 }
 
 bool Board::is_black_king(Square sq) const {
-  return b_king & 1ULL << static_cast<int>(sq);
+  return pieces(c::black, Piece::king) & 1ULL << static_cast<int>(sq);
 }
 
 bool Board::is_king(const Square sq) const {
@@ -190,11 +170,11 @@ bool Board::is_king(const Square sq) const {
 }
 
 bool Board::is_white_pawn(Square sq) const {
-  return w_Pawn & 1ULL << static_cast<int>(sq);
+  return pieces(c::white, Piece::pawn) & 1ULL << static_cast<int>(sq);
 }
 
 bool Board::is_black_pawn(Square sq) const {
-  return b_pawn & 1ULL << static_cast<int>(sq);
+  return pieces(c::black, Piece::pawn) & 1ULL << static_cast<int>(sq);
 }
 
 bool Board::is_pawn(const Square sq) const {
@@ -202,13 +182,11 @@ bool Board::is_pawn(const Square sq) const {
 }
 
 bool Board::is_white(const Square sq) const {
-  return is_white_pawn(sq) || is_white_king(sq) || is_white_knight(sq) ||
-         is_white_bishop(sq) || is_white_rook(sq) || is_white_queen(sq);
+  return occupied(c::white) & bitboard::square(sq);
 }
 
 bool Board::is_black(const Square sq) const {
-  return is_black_pawn(sq) || is_black_king(sq) || is_black_knight(sq) ||
-         is_black_bishop(sq) || is_black_rook(sq) || is_black_queen(sq);
+  return occupied(c::black) & bitboard::square(sq);
 }
 
 Color Board::what_color(const Square sq) const {
@@ -225,153 +203,40 @@ bool Board::is_same_color(const Square sq, const Color color) const {
   return what_color(sq) == color;
 }
 
-bool Board::is_empty(const Square sq) const { return what_piece(sq) == ' '; }
+bool Board::is_empty(const Square sq) const {
+  return mailbox_code(sq) == 0;
+}
 
 bool Board::is_opposite_king(const Square sq, const Color c) const {
   return c == Color::white ? is_black_king(sq) : is_white_king(sq);
 }
 
-int Board::get_row(const Square sq) {
-  if (sq >= s::h1 && sq <= s::a1) {
-    return 1;
-  }
-  if (sq >= s::h2 && sq <= s::a2) {
-    return 2;
-  }
-  if (sq >= s::h3 && sq <= s::a3) {
-    return 3;
-  }
-  if (sq >= s::h4 && sq <= s::a4) {
-    return 4;
-  }
-  if (sq >= s::h5 && sq <= s::a5) {
-    return 5;
-  }
-  if (sq >= s::h6 && sq <= s::a6) {
-    return 6;
-  }
-  if (sq >= s::h7 && sq <= s::a7) {
-    return 7;
-  }
-  if (sq >= s::h8 && sq <= s::a8) {
-    return 8;
-  }
-  return 0;
-}
-
-int Board::get_column(Square sq) {
-  if (static_cast<int>(sq) % 8 == 0) {
-    return 8;
-  }
-  if (static_cast<int>(sq) % 8 == 1) {
-    return 7;
-  }
-  if (static_cast<int>(sq) % 8 == 2) {
-    return 6;
-  }
-  if (static_cast<int>(sq) % 8 == 3) {
-    return 5;
-  }
-  if (static_cast<int>(sq) % 8 == 4) {
-    return 4;
-  }
-  if (static_cast<int>(sq) % 8 == 5) {
-    return 3;
-  }
-  if (static_cast<int>(sq) % 8 == 6) {
-    return 2;
-  }
-  if (static_cast<int>(sq) % 8 == 7) {
-    return 1;
-  }
-  return 0;
-}
-
-bool Board::is_inSameRow(const Square sq1, const Square sq2) {
-  return get_row(sq1) == get_row(sq2);
-}
-
-bool Board::is_inSameRow(const Square sq1, const Square sq2, const Square sq3) {
-  return is_inSameRow(sq1, sq2) && is_inSameRow(sq2, sq3);
-}
+uint64_t Board::occupied() const { return by_color[0] | by_color[1]; }
 
-bool Board::is_inSameColumn(const Square sq1, const Square sq2) {
-  return get_column(sq1) == get_column(sq2);
+uint64_t Board::occupied(const Color c) const {
+  return by_color[static_cast<int>(c)];
 }
 
-bool Board::is_inSameColumn(const Square sq1, const Square sq2,
-                            const Square sq3) {
-  return is_inSameColumn(sq1, sq2) && is_inSameColumn(sq2, sq3);
-}
-
-bool Board::is_inSameDiagonal_leftRight(const Square sq1, const Square sq2) {
-  for (const auto &v : Diagonals::leftRight) {
-    for (const auto &e : v) {
-      if (sq1 == e) {
-        for (const auto &e2 : v) {
-          if (sq2 == e2) {
-            return true;
-          }
-        }
-      }
-    }
-  }
-  return false;
-}
-
-bool Board::is_inSameDiagonal_leftRight(const Square sq1, const Square sq2,
-                                        const Square sq3) {
-  return is_inSameDiagonal_leftRight(sq1, sq2) &&
-         is_inSameDiagonal_leftRight(sq2, sq3);
-}
-
-bool Board::is_inSameDiagonal_rightLeft(const Square sq1, const Square sq2) {
-  for (const auto &v : Diagonals::rightLeft) {
-    for (const auto &e : v) {
-      if (sq1 == e) {
-        for (const auto &e2 : v) {
-          if (sq2 == e2) {
-            return true;
-          }
-        }
-      }
-    }
-  }
-  return false;
-}
-
-bool Board::is_inSameDiagonal_rightLeft(const Square sq1, const Square sq2,
-                                        const Square sq3) {
-  return is_inSameDiagonal_rightLeft(sq1, sq2) &&
-         is_inSameDiagonal_rightLeft(sq2, sq3);
+uint64_t Board::xray_occupancy(const Square sq) const {
+  const Color enemy = is_white(sq) ? c::black : c::white;
+  return occupied() & ~pieces(enemy, Piece::king);
 }
 
 // END piece detection
 //------------------------------------------------------------------------------
 // BEGIN FEN
 
-namespace fen_piece_placement {
-bool isBitSet(const uint64_t n, Square sq) {
-  return n & 1ULL << static_cast<int>(sq);
-}
-} // namespace fen_piece_placement
-
 std::string Board::fen_piece_placement() const {
   std::string piece_placement;
   int emptySquares = 0; // to count empty squares
   for (auto sq = s::a8; sq >= s::h1; --sq) {
-    bool pieceFound = false;
-    // search the square for each type of piece
-    for (const auto &[fst, snd] : piece_map) {
-      if (fen_piece_placement::isBitSet(snd, sq)) {
-        if (emptySquares > 0) {
-          piece_placement += std::to_string(emptySquares);
-          emptySquares = 0;
-        }
-        piece_placement += fst;
-        pieceFound = true;
-        break;
+    const bool pieceFound = !is_empty(sq);
+    if (pieceFound) {
+      if (emptySquares > 0) {
+        piece_placement += std::to_string(emptySquares);
+        emptySquares = 0;
       }
+      piece_placement += what_piece(sq);
     }
     // count empty squares
     if (!pieceFound) {
@@ -395,197 +260,249 @@ std::string Board::fen_piece_placement() const {
   return piece_placement;
 }
 
-std::string Board::export_fen() const {
-  std::string fen; // string to be exported
-  fen += fen_piece_placement();
-  fen += ' ';
-  fen += game_state.fen_active_color();
-  fen += ' ';
-  fen += game_state.fen_castling_ability();
-  fen += ' ';
-  fen += game_state.fen_en_passant_targets();
-  fen += ' ';
-  fen += game_state.fen_half_move_clock();
-  fen += ' ';
-  fen += game_state.fen_full_move_number();
-  return fen;
-}
-
-namespace set_pieces {
-bool is_piece(const char &ch) {
-  return ch == 'p' || ch == 'n' || ch == 'b' || ch == 'r' || ch == 'q' ||
-         ch == 'k' || ch == 'P' || ch == 'N' || ch == 'B' || ch == 'R' ||
-         ch == 'Q' || ch == 'K';
-}
-} // namespace set_pieces
-
-uint Board::set_pieces(const std::string &fen) const {
-  auto square = s::a8;
-  uint counter{};
-  for (const auto &ch : fen) {
-    if (set_pieces::is_piece(ch)) {
-      this->place_piece(square, ch);
-      --square;
-    }
-    if (std::isdigit(ch)) {
-      for (auto i = 0; i < ch - '0'; i++) {
-        --square;
+char *Board::write_fen(char *out) const {
+  // placement, from a8 down to h1 two squares per mailbox byte
+  int empty = 0;
+  for (int sq = 63; sq >= 0; --sq) {
+    const int code = mailbox[sq / 2] >> (sq % 2 * 4) & 0xF;
+    if (code == 0) {
+      ++empty;
+    } else {
+      if (empty > 0) {
+        *out++ = static_cast<char>('0' + empty);
+        empty = 0;
       }
+      *out++ = PIECE_CHARS[code];
     }
-    if (ch == ' ') {
-      counter++;
-      break;
+    if (sq % 8 == 0) {
+      if (empty > 0) {
+        *out++ = static_cast<char>('0' + empty);
+        empty = 0;
+      }
+      if (sq != 0) {
+        *out++ = '/';
+      }
     }
-    counter++;
   }
-  return counter;
+
+  *out++ = ' ';
+  *out++ = game_state.fen_active_color();
+
+  *out++ = ' ';
+  if (game_state.castling == 0) {
+    *out++ = '-';
+  } else {
+    for (int i = 0; i < 4; ++i) {
+      if (game_state.castling & 1 << i) {
+        *out++ = "KQkq"[i];
+      }
+    }
+  }
+
+  *out++ = ' ';
+  if (game_state.en_passant_target == s::none) {
+    *out++ = '-';
+  } else {
+    const int sq = static_cast<int>(game_state.en_passant_target);
+    *out++ = static_cast<char>('h' - sq % 8);
+    *out++ = static_cast<char>('1' + sq / 8);
+  }
+
+  *out++ = ' ';
+  out = std::to_chars(out, out + 5, game_state.half_move_clock).ptr;
+  *out++ = ' ';
+  return std::to_chars(out, out + 5, game_state.full_move_number).ptr;
+}
+
+std::string Board::export_fen() const {
+  char fen[FEN_MAX];
+  return {fen, write_fen(fen)};
 }
 
-void Board::import_fen(const std::string &fen) {
-  std::string temp;
+namespace {
 
-  // clear the board
-  clear();
+/// mailbox code of each FEN piece letter, -1 for anything else
+constexpr std::array<int8_t, 128> piece_code = [] {
+  std::array<int8_t, 128> table{};
+  table.fill(-1);
+  for (int code = 1; Board::PIECE_CHARS[code] != '\0'; ++code) {
+    table[static_cast<unsigned char>(Board::PIECE_CHARS[code])] =
+        static_cast<int8_t>(code);
+  }
+  return table;
+}();
 
-  // set pieces and create game state string
-  const std::string game_state_string = fen.substr(set_pieces(fen));
+/// @return The index just past the spaces starting at i
+std::size_t skip_spaces(const std::string_view s, std::size_t i) {
+  while (i < s.size() && (s[i] == ' ' || s[i] == '\t')) {
+    ++i;
+  }
+  return i;
+}
 
-  // set games state variables
-  std::istringstream iss(game_state_string);
+/// @return The index of the first space or tab at or after i, or the end
+std::size_t field_end(const std::string_view s, std::size_t i) {
+  while (i < s.size() && s[i] != ' ' && s[i] != '\t' && s[i] != '\n' &&
+         s[i] != '\r') {
+    ++i;
+  }
+  return i;
+}
 
-  // create variables
-  char active_color;
-  std::string castling_ability;
-  std::string en_passant_target;
-  uint half_move_clock;
-  uint full_move_number;
+} // namespace
 
-  // gather data
-  iss >> active_color >> castling_ability >> en_passant_target >>
-      half_move_clock >> full_move_number;
+std::size_t Board::parse_fen(const std::string_view fen) {
+  clear();
+  std::size_t i = skip_spaces(fen, 0);
+  std::size_t end = field_end(fen, i);
+  const auto fail = [this] {
+    clear();
+    return std::size_t{0};
+  };
+
+  // piece placement: every rank must add up to exactly eight squares
+  int square = 64;
+  for (std::size_t j = i; j < end; ++j) {
+    const auto ch = static_cast<unsigned char>(fen[j]);
+    if (ch == '/') {
+      if (square % 8 != 0) {
+        return fail();
+      }
+    } else if (ch >= '1' && ch <= '8') {
+      square -= ch - '0';
+    } else if (ch < 128 && piece_code[ch] > 0 && square > 0) {
+      place_code(static_cast<Square>(--square), piece_code[ch]);
+    } else {
+      return fail();
+    }
+  }
+  if (square != 0) {
+    return fail();
+  }
 
-  // assign to board variables
   // active color
-  active_color == 'w' ? game_state.active_color = Color::white
-                      : game_state.active_color = Color::black;
+  i = skip_spaces(fen, end);
+  end = field_end(fen, i);
+  if (end - i != 1 || (fen[i] != 'w' && fen[i] != 'b')) {
+    return fail();
+  }
+  game_state.active_color = fen[i] == 'w' ? Color::white : Color::black;
 
   // castling ability
-  game_state.set_castling_ability(castling_ability);
-  game_state.en_passant_target = en_passant_target;
-  game_state.half_move_clock = half_move_clock;
-  game_state.full_move_number = full_move_number;
+  i = skip_spaces(fen, end);
+  end = field_end(fen, i);
+  const std::string_view castling = fen.substr(i, end - i);
+  if (castling.empty() ||
+      (castling != "-" &&
+       castling.find_first_not_of("KQkq") != std::string_view::npos)) {
+    return fail();
+  }
+  game_state.set_castling_ability(castling);
+
+  // en passant target
+  i = skip_spaces(fen, end);
+  end = field_end(fen, i);
+  if (end - i == 2 && fen[i] >= 'a' && fen[i] <= 'h' && fen[i + 1] >= '1' &&
+      fen[i + 1] <= '8') {
+    // h1 is square 0, and the a-file is the high end of each rank
+    game_state.en_passant_target =
+        static_cast<Square>((fen[i + 1] - '1') * 8 + ('h' - fen[i]));
+  } else if (end - i != 1 || fen[i] != '-') {
+    return fail();
+  }
+
+  // the clocks, which EPD leaves out
+  game_state.half_move_clock = 0;
+  game_state.full_move_number = 1;
+  for (uint16_t *clock :
+       {&game_state.half_move_clock, &game_state.full_move_number}) {
+    const std::size_t start = skip_spaces(fen, end);
+    const auto [ptr, ec] =
+        std::from_chars(fen.data() + start, fen.data() + fen.size(), *clock);
+    if (ec != std::errc()) {
+      break;
+    }
+    end = static_cast<std::size_t>(ptr - fen.data());
+  }
+  key = compute_key();
+  return end;
 }
 
+void Board::import_fen(const std::string_view fen) { parse_fen(fen); }
+
 // END FEN
 //------------------------------------------------------------------------------
-// BEGIN legal moves
+// BEGIN packed position
 
-std::vector<Square> Board::legal_moves_pawn(Square sq) const {
-  std::vector<Square> pawn_moves{};
-  if (is_white_pawn(sq)) {
-    const int isq = static_cast<int>(sq);
-    const bool starting_row = isq <= 15 && isq >= 8;
-    if (is_empty(sq + 8)) {
-      pawn_moves.push_back(sq + 8);
-    }
-    if (starting_row && is_empty(sq + 8) && is_empty(sq + 16)) {
-      pawn_moves.push_back(sq + 16);
-    }
+namespace {
+
+void put16(uint8_t *p, const uint16_t v) {
+  p[0] = static_cast<uint8_t>(v);
+  p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+uint16_t get16(const uint8_t *p) {
+  return static_cast<uint16_t>(p[0] | p[1] << 8);
+}
+
+} // namespace
+
+bool Board::encode(Packed_Position *out) const {
+  uint64_t occ = occupied();
+  if (bitboard::count(occ) > 32) {
+    return false;
   }
-  if (is_black_pawn(sq)) {
-    const int isq = static_cast<int>(sq);
-    const bool starting_row = isq <= 55 && isq >= 48;
-    if (is_empty(sq - 8)) {
-      pawn_moves.push_back(sq - 8);
-    }
-    if (starting_row && is_empty(sq - 8) && is_empty(sq - 16)) {
-      pawn_moves.push_back(sq - 16);
-    }
+  uint8_t *b = out->data();
+  out->fill(0);
+  for (int i = 0; i < 8; ++i) {
+    b[i] = static_cast<uint8_t>(occ >> 8 * i);
+  }
+  for (int n = 0; occ; ++n) {
+    const int code = mailbox_code(bitboard::pop_lsb(occ));
+    b[8 + n / 2] |= static_cast<uint8_t>(code << (n % 2 * 4));
   }
-  return pawn_moves;
+  b[24] = static_cast<uint8_t>((game_state.active_color == c::black) |
+                               game_state.castling << 1);
+  b[25] = static_cast<uint8_t>(game_state.en_passant_target);
+  put16(b + 26, game_state.half_move_clock);
+  put16(b + 28, game_state.full_move_number);
+  return true;
 }
 
-std::vector<Square> Board::legal_moves(const Square sq) const {
-  std::vector<Square> moves{};
-  std::vector<Square> temp = influence(sq);
-
-  if (!is_pawn(sq)) {
-    for (const auto &square : temp) {
-      if (!is_same_color(sq, what_color(square))) {
-        moves.push_back(square);
-      }
-    }
+bool Board::decode(const Packed_Position &packed) {
+  clear();
+  const uint8_t *b = packed.data();
+  uint64_t occ = 0;
+  for (int i = 0; i < 8; ++i) {
+    occ |= static_cast<uint64_t>(b[i]) << 8 * i;
   }
-  if (is_pawn(sq)) {
-    Square ept{};
-    bool en_passant = false;
-    if (!game_state.en_passant_target.empty()) {
-      ept = Sq::string_to_square(game_state.en_passant_target);
-      en_passant = true;
-    }
-    for (const auto &square : temp) {
-      if (!is_same_color(sq, what_color(square)) && !is_empty(square)) {
-        moves.push_back(square);
-      }
-      if (en_passant && square == ept) {
-        if (get_row(ept) == 3 && is_black_pawn(sq)) {
-          moves.push_back(ept);
-        }
-      }
-      if (en_passant && square == ept) {
-        if (get_row(ept) == 6 && is_white_pawn(sq)) {
-          moves.push_back(ept);
-        }
-      }
-    }
-    for (std::vector<Square> temp1 = legal_moves_pawn(sq);
-         const auto &square : temp1) {
-      moves.push_back(square);
+  if (bitboard::count(occ) > 32 || b[24] >> 5 || b[25] > 64 || b[30] ||
+      b[31]) {
+    return false;
+  }
+  for (int n = 0; occ; ++n) {
+    const int code = b[8 + n / 2] >> (n % 2 * 4) & 0xF;
+    if (code == 0 || code > 12) {
+      clear();
+      return false;
     }
+    place_code(bitboard::pop_lsb(occ), code);
   }
-  return moves;
+  game_state.active_color = b[24] & 1 ? c::black : c::white;
+  game_state.castling = static_cast<uint8_t>(b[24] >> 1);
+  game_state.en_passant_target = static_cast<Square>(b[25]);
+  game_state.half_move_clock = get16(b + 26);
+  game_state.full_move_number = get16(b + 28);
+  key = compute_key();
+  return true;
 }
 
-// END legal moves
+// END packed position
 //------------------------------------------------------------------------------
 // BEGIN influence rook
 
 std::vector<Square> Board::influence_rook(const Square sq) const {
-  std::vector<Square> influence{};
-  influence.reserve(16);
-  // vertical up
-  for (auto square = sq + 8; !is_upper_vertical_boundary(square - 8);
-       square = square + 8) {
-    influence.push_back(square);
-    if (!is_empty(square) && !is_opposite_king(square, what_color(sq))) {
-      break;
-    }
-  }
-  // vertical down
-  for (auto square = sq - 8; !is_lower_vertical_boundary(square + 8);
-       square = square - 8) {
-    influence.push_back(square);
-    if (!is_empty(square) && !is_opposite_king(square, what_color(sq))) {
-      break;
-    }
-  }
-  // horizontal right
-  for (auto square = sq - 1; !is_right_horizontal_boundary(square + 1);
-       square = square - 1) {
-    influence.push_back(square);
-    if (!is_empty(square) && !is_opposite_king(square, what_color(sq))) {
-      break;
-    }
-  }
-  // horizontal left
-  for (auto square = sq + 1; !is_left_horizontal_boundary(square - 1);
-       square = square + 1) {
-    influence.push_back(square);
-    if (!is_empty(square) && !is_opposite_king(square, what_color(sq))) {
-      break;
-    }
-  }
-  return influence;
+  return bitboard::squares(Attacks::rook(sq, xray_occupancy(sq)));
 }
 
 // END influence rook
@@ -593,45 +510,7 @@ std::vector<Square> Board::influence_rook(const Square sq) const {
 // BEGIN influence bishop
 
 std::vector<Square> Board::influence_bishop(const Square sq) const {
-  std::vector<Square> influence{};
-  influence.reserve(16);
-  // up left
-  for (auto square = sq + 9; !is_upper_vertical_boundary(square - 9) &&
-                             !is_left_horizontal_boundary(square - 9);
-       square = square + 9) {
-    influence.push_back(square);
-    if (!is_empty(square) && !is_opposite_king(square, what_color(sq))) {
-      break;
-    }
-  }
-  // up right
-  for (auto square = sq + 7; !is_upper_vertical_boundary(square - 7) &&
-                             !is_right_horizontal_boundary(square - 7);
-       square = square + 7) {
-    influence.push_back(square);
-    if (!is_empty(square) && !is_opposite_king(square, what_color(sq))) {
-      break;
-    }
-  }
-  // down right
-  for (auto square = sq - 9; !is_lower_vertical_boundary(square + 9) &&
-                             !is_right_horizontal_boundary(square + 9);
-       square = square - 9) {
-    influence.push_back(square);
-    if (!is_empty(square) && !is_opposite_king(square, what_color(sq))) {
-      break;
-    }
-  }
-  // down left
-  for (auto square = sq - 7; !is_lower_vertical_boundary(square + 7) &&
-                             !is_left_horizontal_boundary(square + 7);
-       square = square - 7) {
-    influence.push_back(square);
-    if (!is_empty(square) && !is_opposite_king(square, what_color(sq))) {
-      break;
-    }
-  }
-  return influence;
+  return bitboard::squares(Attacks::bishop(sq, xray_occupancy(sq)));
 }
 
 // END influence bishop
@@ -639,142 +518,15 @@ std::vector<Square> Board::influence_bishop(const Square sq) const {
 // BEGIN influence queen
 
 std::vector<Square> Board::influence_queen(const Square sq) const {
-  std::vector<Square> v1 = influence_rook(sq);
-  std::vector<Square> v2 = influence_bishop(sq);
-  std::vector<Square> influence;
-  influence.reserve(32);
-  influence.insert(influence.end(), v1.begin(), v1.end());
-  influence.insert(influence.end(), v2.begin(), v2.end());
-  return influence;
+  return bitboard::squares(Attacks::queen(sq, xray_occupancy(sq)));
 }
 
 // END influence queen
 //------------------------------------------------------------------------------
 // BEGIN influence knight
 
-std::vector<Square> Board::influence_knight(Square sq) {
-  std::vector<Square> influence{};
-  influence.reserve(8);
-
-  // center 4x4 - 16 squares
-  if (const int isq = static_cast<int>(sq);
-      (isq >= 18 && isq <= 21) || (isq >= 26 && isq <= 29) ||
-      (isq >= 34 && isq <= 37) || (isq >= 42 && isq <= 45)) {
-    influence.push_back(sq - (2 * 8 + 1)); // down right
-    influence.push_back(sq - (2 * 8 - 1)); // down left
-    influence.push_back(sq - (8 + 2));     // right down
-    influence.push_back(sq - (8 - 2));     // left down
-    influence.push_back(sq + (8 - 2));     // right up
-    influence.push_back(sq + (8 + 2));     // left up
-    influence.push_back(sq + (2 * 8 - 1)); // up right
-    influence.push_back(sq + (2 * 8 + 1)); // up left
-  }
-  // b file - 4 squares
-  else if (sq == s::b3 || sq == s::b4 || sq == s::b5 || sq == s::b6) {
-    influence.push_back(sq - (2 * 8 + 1)); // down right
-    influence.push_back(sq - (2 * 8 - 1)); // down left
-    influence.push_back(sq - (8 + 2));     // right down
-    influence.push_back(sq + (8 - 2));     // right up
-    influence.push_back(sq + (2 * 8 - 1)); // up right
-    influence.push_back(sq + (2 * 8 + 1)); // up left
-  }
-  // g files - 4 squares
-  else if (sq == s::g3 || sq == s::g4 || sq == s::g5 || sq == s::g6) {
-    influence.push_back(sq - (2 * 8 + 1)); // down right
-    influence.push_back(sq - (2 * 8 - 1)); // down left
-    influence.push_back(sq - (8 - 2));     // left down
-    influence.push_back(sq + (8 + 2));     // left up
-    influence.push_back(sq + (2 * 8 - 1)); // up right
-    influence.push_back(sq + (2 * 8 + 1)); // up left
-  }
-  // 2nd rank - 4 squares
-  else if (isq >= static_cast<int>(s::f2) && isq <= static_cast<int>(s::c2)) {
-    influence.push_back(sq - (8 + 2));     // right down
-    influence.push_back(sq - (8 - 2));     // left down
-    influence.push_back(sq + (8 - 2));     // right up
-    influence.push_back(sq + (8 + 2));     // left up
-    influence.push_back(sq + (2 * 8 - 1)); // up right
-    influence.push_back(sq + (2 * 8 + 1)); // up left
-  }
-  // 7th rank - 4 squares
-  else if (isq >= static_cast<int>(s::f7) && isq <= static_cast<int>(s::c7)) {
-    influence.push_back(sq - (2 * 8 + 1)); // down right
-    influence.push_back(sq - (2 * 8 - 1)); // down left
-    influence.push_back(sq - (8 + 2));     // right down
-    influence.push_back(sq - (8 - 2));     // left down
-    influence.push_back(sq + (8 - 2));     // right up
-    influence.push_back(sq + (8 + 2));     // left up
-  }
-  // a file - 4 squares
-  else if (sq == s::a3 || sq == s::a4 || sq == s::a5 || sq == s::a6) {
-    influence.push_back(sq - (2 * 8 + 1)); // down right
-    influence.push_back(sq - (8 + 2));     // right down
-    influence.push_back(sq + (8 - 2));     // right up
-    influence.push_back(sq + (2 * 8 - 1)); // up right
-  }
-  // h file - 4 squares
-  else if (sq == s::h3 || sq == s::h4 || sq == s::h5 || sq == s::h6) {
-    influence.push_back(sq - (2 * 8 - 1)); // down left
-    influence.push_back(sq - (8 - 2));     // left down
-    influence.push_back(sq + (8 + 2));     // left up
-    influence.push_back(sq + (2 * 8 + 1)); // up left
-  }
-  // 1st rank - 4 squares
-  else if (isq >= static_cast<int>(s::f1) && isq <= static_cast<int>(s::c1)) {
-    influence.push_back(sq + (8 - 2));     // right up
-    influence.push_back(sq + (8 + 2));     // left up
-    influence.push_back(sq + (2 * 8 - 1)); // up right
-    influence.push_back(sq + (2 * 8 + 1)); // up left
-  }
-  // 8th rank - 4 squares
-  else if (isq >= static_cast<int>(s::f8) && isq <= static_cast<int>(s::c8)) {
-    influence.push_back(sq - (2 * 8 + 1)); // down right
-    influence.push_back(sq - (2 * 8 - 1)); // down left
-    influence.push_back(sq - (8 + 2));     // right down
-    influence.push_back(sq - (8 - 2));     // left down
-  }
-  // inside 2's and 7's - 1 square each
-  else if (isq == static_cast<int>(s::g2)) {
-    influence = {s::e1, s::e3, s::h4, s::f4};
-  } else if (isq == static_cast<int>(s::b2)) {
-    influence = {s::d1, s::d3, s::c4, s::a4};
-  } else if (isq == static_cast<int>(s::g7)) {
-    influence = {s::h5, s::f5, s::e6, s::e8};
-  } else if (isq == static_cast<int>(s::b7)) {
-    influence = {s::c5, s::a5, s::d6, s::d8};
-  }
-  // edge 2's and 7's - 1 square each
-  else if (isq == static_cast<int>(s::h2)) {
-    influence = {s::f1, s::f3, s::g4};
-  } else if (isq == static_cast<int>(s::a2)) {
-    influence = {s::c1, s::c3, s::b4};
-  } else if (isq == static_cast<int>(s::h7)) {
-    influence = {s::g5, s::f6, s::f8};
-  } else if (isq == static_cast<int>(s::a7)) {
-    influence = {s::b5, s::c6, s::c8};
-  }
-  // edge 1's and 8's - 1 square each
-  else if (isq == static_cast<int>(s::g1)) {
-    influence = {s::e2, s::h3, s::f3};
-  } else if (isq == static_cast<int>(s::b1)) {
-    influence = {s::d2, s::c3, s::a3};
-  } else if (isq == static_cast<int>(s::g8)) {
-    influence = {s::h6, s::f6, s::e7};
-  } else if (isq == static_cast<int>(s::b8)) {
-    influence = {s::c6, s::a6, s::d7};
-  }
-  // corners - 1 square each
-  else if (isq == static_cast<int>(s::h1)) {
-    influence = {s::f2, s::g3};
-  } else if (isq == static_cast<int>(s::a1)) {
-    influence = {s::c2, s::b3};
-  } else if (isq == static_cast<int>(s::h8)) {
-    influence = {s::g6, s::f7};
-  } else if (isq == static_cast<int>(s::a8)) {
-    influence = {s::b6, s::c7};
-  }
-
-  return influence;
+std::vector<Square> Board::influence_knight(const Square sq) {
+  return bitboard::squares(Attacks::knight[static_cast<int>(sq)]);
 }
 
 // END influence knight
@@ -782,37 +534,7 @@ std::vector<Square> Board::influence_knight(Square sq) {
 // BEGIN influence king
 
 std::vector<Square> Board::influence_king(const Square sq) {
-  std::vector<Square> influence{};
-  influence.reserve(16);
-  // vertical
-  if (!is_upper_vertical_boundary(sq)) {
-    influence.push_back(sq + 8);
-  }
-  if (!is_lower_vertical_boundary(sq)) {
-    influence.push_back(sq - 8);
-  }
-  // horizontal
-  if (!is_right_horizontal_boundary(sq)) {
-    influence.push_back(sq - 1);
-  }
-  if (!is_left_horizontal_boundary(sq)) {
-    influence.push_back(sq + 1);
-  }
-  // diagonal
-  if (!is_lower_vertical_boundary(sq) && !is_right_horizontal_boundary(sq)) {
-    influence.push_back(sq - 9);
-  }
-  if (!is_lower_vertical_boundary(sq) && !is_left_horizontal_boundary(sq)) {
-    influence.push_back(sq - 7);
-  }
-  if (!is_upper_vertical_boundary(sq) && !is_right_horizontal_boundary(sq)) {
-    influence.push_back(sq + 7);
-  }
-  if (!is_upper_vertical_boundary(sq) && !is_left_horizontal_boundary(sq)) {
-    influence.push_back(sq + 9);
-  }
-
-  return influence;
+  return bitboard::squares(Attacks::king[static_cast<int>(sq)]);
 }
 
 // END influence king
@@ -820,20 +542,9 @@ std::vector<Square> Board::influence_king(const Square sq) {
 // BEGIN influence pawn
 
 std::vector<Square> Board::influence_pawn(const Square sq) const {
-  std::vector<Square> influence{};
-  influence.reserve(8);
-  constexpr int front_left = 9;
-  constexpr int front_right = 7;
-
-  if (!is_left_horizontal_boundary(sq)) {
-    is_white_pawn(sq) ? influence.push_back(sq + front_left)
-                      : influence.push_back(sq - front_right);
-  }
-  if (!is_right_horizontal_boundary(sq)) {
-    is_white_pawn(sq) ? influence.push_back(sq + front_right)
-                      : influence.push_back(sq - front_left);
-  }
-  return influence;
+  const Color c = is_white_pawn(sq) ? Color::white : Color::black;
+  return bitboard::squares(
+      Attacks::pawn[static_cast<int>(c)][static_cast<int>(sq)]);
 }
 
 // END influence pawn
@@ -866,27 +577,6 @@ std::vector<Square> Board::influence(const Square sq) const {
 
 // END influence
 //------------------------------------------------------------------------------
-// BEGIN update influence maps
-
-void Board::update_influence_maps() const {
-  // reset the maps
-  maps->white_influence.clear();
-  maps->black_influence.clear();
-
-  for (auto sq = s::a8; sq >= s::h1; --sq) {
-    // white moves
-    if (is_white(sq)) {
-      maps->white_influence.insert({sq, influence(sq)});
-    }
-    // black moves
-    else if (is_black(sq)) {
-      maps->black_influence.insert({sq, influence(sq)});
-    }
-  }
-}
-
-// END update influence maps
-//------------------------------------------------------------------------------
 // BEGIN pinned piece rook
 
 Square Board::pinned_piece_rook(const Square sq) const {
@@ -1169,464 +859,782 @@ Square Board::pinned_piece(const Square sq) const {
 
 // END pinned pieces
 //------------------------------------------------------------------------------
-// BEGIN update pinned pieces
-
-void Board::update_pinned_pieces() const {
-  // reset the maps
-  maps->white_pinned.clear();
-  maps->black_pinned.clear();
+// BEGIN update move maps
 
-  for (const auto &sq : maps->white_influence | std::views::keys) {
-    if (pinned_piece(sq) != sq) {
-      maps->black_pinned.insert({pinned_piece(sq), sq});
-    }
-  }
-  for (const auto &sq : maps->black_influence | std::views::keys) {
-    if (pinned_piece(sq) != sq) {
-      maps->white_pinned.insert({pinned_piece(sq), sq});
+namespace {
+
+/// Append a move to every square in targets, marking captures
+void push_moves(const Square from, uint64_t targets, const uint64_t them,
+                MoveList *moves) {
+  while (targets) {
+    const Square to = bitboard::pop_lsb(targets);
+    moves->push_back(Move(from, to,
+                          them & bitboard::square(to) ? Move::capture
+                                                      : Move::quiet));
+  }
+}
+
+/// Append a pawn move to every square in targets, one per promotion piece
+void push_pawn_moves(const Square from, uint64_t targets, const uint64_t them,
+                     MoveList *moves) {
+  while (targets) {
+    const Square to = bitboard::pop_lsb(targets);
+    const uint64_t b = bitboard::square(to);
+    const int distance = static_cast<int>(to) - static_cast<int>(from);
+    const uint16_t flags = them & b ? Move::capture : Move::quiet;
+    if (b & (bitboard::RANK_1 | bitboard::RANK_8)) {
+      for (int piece = 3; piece >= 0; --piece) { // queen, rook, bishop, knight
+        moves->push_back(Move(from, to, Move::promotion | flags | piece));
+      }
+    } else if (distance == 16 || distance == -16) {
+      moves->push_back(Move(from, to, Move::double_push));
+    } else {
+      moves->push_back(Move(from, to, flags));
     }
   }
 }
 
-// END update pinned pieces
-//------------------------------------------------------------------------------
-// BEGIN update king moves
+/// Collects the moves generate_legal finds into a list
+struct List_Sink {
+  MoveList *moves;
 
-std::vector<Square> Board::update_white_king_moves(Square sq_w_King) {
-  std::vector<Square> giving_check{};
+  void targets(const Square from, const uint64_t to, const uint64_t them) {
+    push_moves(from, to, them, moves);
+  }
+  void pawn_targets(const Square from, const uint64_t to, const uint64_t them) {
+    push_pawn_moves(from, to, them, moves);
+  }
+  void move(const Move m) { moves->push_back(m); }
+  static constexpr bool done() { return false; }
+};
 
-  std::vector<Square> safe_squares;      // temp vector to create king move list
-  std::vector<Square> legal_moves_kings; // temp vector to create king move list
+/// Counts the moves generate_legal finds without making them
+struct Count_Sink {
+  unsigned count = 0;
 
-  // add castle squares if castling is still valid. Must be done before cleaning
-  // the list because while castling ability may be present, is may not always
-  // be legal to do so, because enemy pieces could be attacking those squares,
-  // or friendly pieces may be blocking them. piece giving check
+  void targets(Square, const uint64_t to, uint64_t) {
+    count += bitboard::count(to);
+  }
+  void pawn_targets(Square, const uint64_t to, uint64_t) {
+    // one move per promotion piece
+    const uint64_t promotions = to & (bitboard::RANK_1 | bitboard::RANK_8);
+    count += bitboard::count(to) + 3 * bitboard::count(promotions);
+  }
+  void move(Move) { ++count; }
+  static constexpr bool done() { return false; }
+};
 
-  // temp vector to create king move list
-  std::vector<Square> influence_kings = influence(sq_w_King);
+/// Stops generate_legal at the first move it finds
+struct Any_Sink {
+  bool found = false;
 
-  // detect whether king is in check
-  bool is_in_check = false; // king is in check
-  for (const auto &[fst, snd] : maps->black_influence) {
-    if (std::ranges::find(snd, sq_w_King) !=
-        snd.end()) { // is the king in check
-      is_in_check = true;
-      game_state.white_inCheck = true;
-      // keep track of who is giving check
-      giving_check.push_back(fst);
-    }
+  void targets(Square, const uint64_t to, uint64_t) { found |= to != 0; }
+  void pawn_targets(Square, const uint64_t to, uint64_t) { found |= to != 0; }
+  void move(Move) { found = true; }
+  [[nodiscard]] bool done() const { return found; }
+};
+
+} // namespace
+
+uint64_t Board::attackers_to(const Square sq, const uint64_t occupied) const {
+  const int i = static_cast<int>(sq);
+  const uint64_t bishops = by_piece[static_cast<int>(Piece::bishop)] |
+                           by_piece[static_cast<int>(Piece::queen)];
+  const uint64_t rooks = by_piece[static_cast<int>(Piece::rook)] |
+                         by_piece[static_cast<int>(Piece::queen)];
+  // a pawn attacks sq if a pawn of the other color on sq would attack it
+  return (Attacks::pawn[static_cast<int>(Color::black)][i] &
+          pieces(Color::white, Piece::pawn)) |
+         (Attacks::pawn[static_cast<int>(Color::white)][i] &
+          pieces(Color::black, Piece::pawn)) |
+         (Attacks::knight[i] & by_piece[static_cast<int>(Piece::knight)]) |
+         (Attacks::king[i] & by_piece[static_cast<int>(Piece::king)]) |
+         (Attacks::bishop(sq, occupied) & bishops) |
+         (Attacks::rook(sq, occupied) & rooks);
+}
+
+bool Board::is_attacked(const Square sq, const Color by) const {
+  return attackers_to(sq, occupied()) & occupied(by);
+}
+
+namespace {
+
+/// @return The value of the piece a move puts on its destination
+int mover_value(const Board &board, const Move move) {
+  if (move.is_promotion()) {
+    return Board::SEE_VALUE[static_cast<int>(Piece::knight) +
+                            (move.flags() & 3)];
   }
-  if (!is_in_check) { // if not in check, add castling moves (if available)
-    if (game_state.castle_w_K) {
-      influence_kings.push_back(s::g1);
-    }
-    if (game_state.castle_w_Q) {
-      influence_kings.push_back(s::c1);
-    }
+  return Board::SEE_VALUE[static_cast<int>(board.piece_on(move.from()))];
+}
+
+/// @return The material a move wins before any recapture
+int capture_value(const Board &board, const Move move) {
+  int value =
+      move.flags() == Move::en_passant
+          ? Board::SEE_VALUE[static_cast<int>(Piece::pawn)]
+          : Board::SEE_VALUE[static_cast<int>(board.piece_on(move.to()))];
+  if (move.is_promotion()) {
+    value += mover_value(board, move) -
+             Board::SEE_VALUE[static_cast<int>(Piece::pawn)];
   }
+  return value;
+}
 
-  // remove square that are under attack
-  for (const auto &sq : influence_kings) {
-    // flags a square as under attack
-    bool under_attack = false; // reset search flag
-    for (const auto &moves : maps->black_influence | std::views::values) {
-      if (std::ranges::find(moves, sq) != moves.end()) {
-        under_attack = true;
-        break;
-      }
+/// @return The occupancy once the move is made, its destination left empty
+uint64_t occupancy_after(const Board &board, const Move move) {
+  uint64_t occ = board.occupied() & ~bitboard::square(move.from()) &
+                 ~bitboard::square(move.to());
+  if (move.flags() == Move::en_passant) {
+    // the captured pawn is beside the pawn that takes it
+    const int from = static_cast<int>(move.from());
+    const int to = static_cast<int>(move.to());
+    occ &= ~(1ULL << ((from & ~7) | (to & 7)));
+  }
+  return occ;
+}
+
+/**
+ * @brief Take the least valuable attacker of one color off the board
+ * @param board The position
+ * @param attackers The pieces attacking the square, of both colors
+ * @param c The color to capture with
+ * @param occ The occupancy, updated
+ * @return The kind of piece that captures, Piece::none if there is none
+ */
+Piece least_valuable(const Board &board, const uint64_t attackers,
+                     const Color c, uint64_t &occ) {
+  const uint64_t own = attackers & board.occupied(c) & occ;
+  for (int p = 0; p < 6; ++p) {
+    if (const uint64_t b = own & board.by_piece[p]) {
+      occ &= ~bitboard::square(bitboard::lsb(b));
+      return static_cast<Piece>(p);
+    }
+  }
+  return Piece::none;
+}
+
+/// @return The sliders that see the square through the occupancy
+uint64_t sliders_to(const Board &board, const Square sq, const uint64_t occ) {
+  const uint64_t queens = board.by_piece[static_cast<int>(Piece::queen)];
+  return (Attacks::bishop(sq, occ) &
+          (board.by_piece[static_cast<int>(Piece::bishop)] | queens)) |
+         (Attacks::rook(sq, occ) &
+          (board.by_piece[static_cast<int>(Piece::rook)] | queens));
+}
+
+} // namespace
+
+int Board::see(const Move move) const {
+  if (move.is_castle()) {
+    return 0;
+  }
+  const Square to = move.to();
+  Color side = what_color(move.from());
+  uint64_t occ = occupancy_after(*this, move);
+  uint64_t attackers = attackers_to(to, occ);
+
+  // gain[d] is what the side capturing at depth d wins if the exchange
+  // stopped after its capture
+  std::array<int, 32> gain{};
+  gain[0] = capture_value(*this, move);
+  int on_square = mover_value(*this, move);
+  int d = 0;
+  while (true) {
+    !side;
+    const Piece p = least_valuable(*this, attackers, side, occ);
+    if (p == Piece::none) {
+      break;
     }
-    if (!under_attack) {
-      safe_squares.push_back(sq);
+    // the king may only take if nothing can take it back
+    Color other = side;
+    !other;
+    if (p == Piece::king && (attackers & occ & occupied(other))) {
+      break;
     }
+    ++d;
+    gain[d] = on_square - gain[d - 1];
+    on_square = SEE_VALUE[static_cast<int>(p)];
+    attackers |= sliders_to(*this, to, occ);
   }
-  // clean list of same color squares (cannot take own pieces)
-  for (const auto &s : safe_squares) {
-    if (!is_same_color(s, c::white)) {
-      legal_moves_kings.push_back(s);
-    }
+  // each side only carries on with the exchange if it is better than stopping
+  while (d > 0) {
+    gain[d - 1] = -std::max(-gain[d - 1], gain[d]);
+    --d;
   }
+  return gain[0];
+}
 
-  // if the legal moves contain a castling square, but not the adjacent square
-  // necessary to legally castle remove the castling square
-  if (game_state.castle_w_K) {
-    if (std::ranges::find(legal_moves_kings, s::g1) !=
-        legal_moves_kings.end()) {
-      if (std::ranges::find(legal_moves_kings, s::f1) ==
-          legal_moves_kings.end()) {
-        // remove g1
-        const auto it = std::ranges::remove(legal_moves_kings, s::g1).begin();
-        legal_moves_kings.erase(it, legal_moves_kings.end());
-      }
-    }
+bool Board::see_ge(const Move move, const int margin) const {
+  if (move.is_castle()) {
+    return 0 >= margin;
   }
-  if (game_state.castle_w_Q) {
-    if (std::ranges::find(legal_moves_kings, s::c1) !=
-        legal_moves_kings.end()) {
-      if (std::ranges::find(legal_moves_kings, s::d1) ==
-          legal_moves_kings.end()) {
-        // remove c1
-        const auto it = std::ranges::remove(legal_moves_kings, s::c1).begin();
-        legal_moves_kings.erase(it, legal_moves_kings.end());
-      }
-      // when castling long, gotta check the third square too. if b1 isn't
-      // empty, can't castle just yet
-      else if (!is_empty(s::b1)) {
-        const auto it = std::ranges::remove(legal_moves_kings, s::c1).begin();
-        legal_moves_kings.erase(it, legal_moves_kings.end());
-      }
-    }
+  // swap is what the side that just captured stands to lose, less what it
+  // needs to win; whoever it favors at any point can stop the exchange there
+  int swap = capture_value(*this, move) - margin;
+  if (swap < 0) {
+    return false; // even if nothing takes back
+  }
+  swap = mover_value(*this, move) - swap;
+  if (swap <= 0) {
+    return true; // even if the mover is taken for nothing
   }
 
-  // add king moves to move map
-  maps->white_moves.insert({sq_w_King, legal_moves_kings});
-
-  return giving_check;
+  const Square to = move.to();
+  Color side = what_color(move.from());
+  uint64_t occ = occupancy_after(*this, move);
+  uint64_t attackers = attackers_to(to, occ);
+  int result = 1;
+  while (true) {
+    !side;
+    const Piece p = least_valuable(*this, attackers, side, occ);
+    if (p == Piece::none) {
+      break;
+    }
+    result ^= 1;
+    if (p == Piece::king) {
+      // the king may only take if nothing can take it back
+      Color other = side;
+      !other;
+      return (attackers & occ & occupied(other)) ? result ^ 1 : result;
+    }
+    if ((swap = SEE_VALUE[static_cast<int>(p)] - swap) < result) {
+      break;
+    }
+    attackers |= sliders_to(*this, to, occ);
+  }
+  return result;
 }
 
-std::vector<Square> Board::update_black_king_moves(Square sq_b_king) {
-  std::vector<Square> giving_check{};
-  std::vector<Square> safe_squares;      // temp vector to create king move list
-  std::vector<Square> legal_moves_kings; // temp vector to create king move list
-
-  // temp vector to create king move list
-  std::vector<Square> influence_kings = influence(sq_b_king);
+uint64_t Board::attacked_squares(const Color c, const uint64_t occupied) const {
+  const uint64_t pawns = pieces(c, Piece::pawn);
+  const int up = c == Color::white ? 1 : -1;
+  uint64_t attacked =
+      bitboard::shift(pawns, 1, up) | bitboard::shift(pawns, -1, up);
 
-  // detect whether king is in check
-  bool is_inCheck = false;
-  for (const auto &[fst, snd] : maps->white_influence) {
-    if (std::ranges::find(snd, sq_b_king) !=
-        snd.end()) { // is the king in check
-      is_inCheck = true;
-      game_state.black_inCheck = true;
-      giving_check.push_back(fst);
-    }
+  for (uint64_t b = pieces(c, Piece::knight); b;) {
+    attacked |= Attacks::knight[static_cast<int>(bitboard::pop_lsb(b))];
   }
-  if (!is_inCheck) { // if not in check, add castling moves (if available)
-    if (game_state.castle_b_k) {
-      influence_kings.push_back(s::g8);
-    }
-    if (game_state.castle_b_q) {
-      influence_kings.push_back(s::c8);
-    }
+  for (uint64_t b = pieces(c, Piece::bishop) | pieces(c, Piece::queen); b;) {
+    attacked |= Attacks::bishop(bitboard::pop_lsb(b), occupied);
   }
+  for (uint64_t b = pieces(c, Piece::rook) | pieces(c, Piece::queen); b;) {
+    attacked |= Attacks::rook(bitboard::pop_lsb(b), occupied);
+  }
+  for (uint64_t b = pieces(c, Piece::king); b;) {
+    attacked |= Attacks::king[static_cast<int>(bitboard::pop_lsb(b))];
+  }
+  return attacked;
+}
 
-  // remove square that are under attack
-  for (const auto &sq : influence_kings) {
-    bool under_attack = false; // reset search flag
-    for (const auto &moves : maps->white_influence | std::views::values) {
-      if (std::ranges::find(moves, sq) != moves.end()) {
-        under_attack = true;
-        break;
-      }
-    }
-    if (!under_attack) {
-      safe_squares.push_back(sq);
-    }
+Check_Info Board::check_info(const Color c) const {
+  Check_Info info{0, 0};
+  const uint64_t king = pieces(c, Piece::king);
+  if (!king) {
+    return info;
   }
-  // clean list of same color squares (cannot take own pieces)
-  for (const auto &s : safe_squares) {
-    if (!is_same_color(s, c::black)) {
-      legal_moves_kings.push_back(s);
+  Color enemy = c;
+  !enemy;
+  const Square sq_king = bitboard::lsb(king);
+  const int k = static_cast<int>(sq_king);
+  const uint64_t us = occupied(c);
+  const uint64_t them = occupied(enemy);
+  const uint64_t occ = us | them;
+  const uint64_t enemy_bishops =
+      pieces(enemy, Piece::bishop) | pieces(enemy, Piece::queen);
+  const uint64_t enemy_rooks =
+      pieces(enemy, Piece::rook) | pieces(enemy, Piece::queen);
+
+  info.checkers = attackers_to(sq_king, occ) & them;
+
+  // pins: an enemy slider lined up with the king, with exactly one of our
+  // pieces in between
+  uint64_t snipers = (Attacks::bishop(sq_king, them) & enemy_bishops) |
+                     (Attacks::rook(sq_king, them) & enemy_rooks);
+  while (snipers) {
+    const int sniper = static_cast<int>(bitboard::pop_lsb(snipers));
+    if (const uint64_t blockers = Geometry::between[k][sniper] & occ;
+        bitboard::count(blockers) == 1 && (blockers & us)) {
+      info.pinned |= blockers;
     }
   }
+  return info;
+}
+
+template <Color Us, class Sink>
+bool Board::generate_legal(Sink &sink, const Gen_Type type) const {
+  constexpr Color c = Us;
+  constexpr bool white = Us == Color::white;
+  constexpr Color enemy = white ? Color::black : Color::white;
+
+  const uint64_t pawns = pieces(c, Piece::pawn);
+  const uint64_t knights = pieces(c, Piece::knight);
+  const uint64_t bishops = pieces(c, Piece::bishop) | pieces(c, Piece::queen);
+  const uint64_t rooks = pieces(c, Piece::rook) | pieces(c, Piece::queen);
+  const uint64_t king = pieces(c, Piece::king);
+  const uint64_t enemy_pawns = pieces(enemy, Piece::pawn);
+  const uint64_t enemy_bishops =
+      pieces(enemy, Piece::bishop) | pieces(enemy, Piece::queen);
+  const uint64_t enemy_rooks =
+      pieces(enemy, Piece::rook) | pieces(enemy, Piece::queen);
+
+  const uint64_t us = occupied(c);
+  const uint64_t them = occupied(enemy);
+  const uint64_t occ = us | them;
+
+  // the squares a piece other than a pawn may move to for this type of move
+  const uint64_t wanted = type == Gen_Type::captures ? them
+                          : type == Gen_Type::quiets ? ~them
+                                                     : ~0ULL;
+  const uint64_t promotion_ranks = bitboard::RANK_1 | bitboard::RANK_8;
+
+  uint64_t check_mask = ~0ULL; // squares that capture or block the checker
+  uint64_t pinned = 0;         // our pieces pinned to our king
+  bool in_check = false;
+  Square sq_king{};
 
-  // if the legal moves contain a castling square, but not the adjacent square
-  // necessary to legally castle remove the castling square
-  if (game_state.castle_b_k) {
-    if (std::ranges::find(legal_moves_kings, s::g8) !=
-        legal_moves_kings.end()) {
-      if (std::ranges::find(legal_moves_kings, s::f8) ==
-          legal_moves_kings.end()) {
-        // remove g8
-        const auto it = std::ranges::remove(legal_moves_kings, s::g8).begin();
-        legal_moves_kings.erase(it, legal_moves_kings.end());
+  if (king) {
+    sq_king = bitboard::lsb(king);
+    const int k = static_cast<int>(sq_king);
+
+    // the king can't step back along a slider's ray, so lift it off the board
+    const auto attacked = [&](uint64_t squares) {
+      while (squares) {
+        if (attackers_to(bitboard::pop_lsb(squares), occ & ~king) & them) {
+          return true;
+        }
+      }
+      return false;
+    };
+    uint64_t safe = 0;
+    for (uint64_t b = Attacks::king[k] & ~us & wanted; b;) {
+      const uint64_t to = bitboard::square(bitboard::pop_lsb(b));
+      if (!attacked(to)) {
+        safe |= to;
       }
     }
-  }
-  if (game_state.castle_b_q) {
-    if (std::ranges::find(legal_moves_kings, s::c8) !=
-        legal_moves_kings.end()) {
-      if (std::ranges::find(legal_moves_kings, s::d8) ==
-          legal_moves_kings.end()) {
-        // remove c1
-        const auto it = std::ranges::remove(legal_moves_kings, s::c8).begin();
-        legal_moves_kings.erase(it, legal_moves_kings.end());
+    sink.targets(sq_king, safe, them);
+
+    const Check_Info info = check_info(c);
+    const uint64_t checkers = info.checkers;
+    pinned = info.pinned;
+    in_check = checkers != 0;
+
+    // if more than one piece is giving check, the king must be moved
+    if (bitboard::count(checkers) > 1 || sink.done()) {
+      return in_check;
+    }
+    // if one piece is giving check, it can be captured or blocked
+    if (checkers) {
+      const int checker = static_cast<int>(bitboard::lsb(checkers));
+      check_mask = checkers | Geometry::between[k][checker];
+    }
+
+    // castling: the squares between king and rook must be empty, and the king
+    // may not start in, pass through or land in check
+    constexpr int r = white ? 0 : 56; // the back rank starts at h1 or h8
+    const uint64_t own_rooks = pieces(c, Piece::rook);
+    if (!in_check && k == r + 3 && type != Gen_Type::captures) {
+      if (game_state.can_castle(white ? Game_State::castle_w_K
+                                      : Game_State::castle_b_k) &&
+          (own_rooks & 1ULL << r) && !(occ & 0x06ULL << r) &&
+          !attacked(0x06ULL << r)) {
+        sink.move(Move(sq_king, sq_king - 2, Move::king_castle));
       }
-      // when castling long, gotta check the third square too. if b8 isn't
-      // empty, can't castle just yet
-      else if (!is_empty(s::b8)) {
-        const auto it = std::ranges::remove(legal_moves_kings, s::c8).begin();
-        legal_moves_kings.erase(it, legal_moves_kings.end());
+      if (game_state.can_castle(white ? Game_State::castle_w_Q
+                                      : Game_State::castle_b_q) &&
+          (own_rooks & 0x80ULL << r) && !(occ & 0x70ULL << r) &&
+          !attacked(0x30ULL << r)) {
+        sink.move(Move(sq_king, sq_king + 2, Move::queen_castle));
       }
     }
   }
 
-  // add king moves to move map
-  maps->black_moves.insert({sq_b_king, legal_moves_kings});
-
-  return giving_check;
-}
-// END update king moves
-//------------------------------------------------------------------------------
-// BEGIN update move maps
-
-Square Board::copy_influence(
-    const Color c, const std::unordered_map<Square, std::vector<Square>> *from,
-    std::unordered_map<Square, std::vector<Square>> *to) const {
-  Square sq_king{};
-  to->clear();
-  if (c == c::white) {
-    for (const auto &[fst, snd] : *from) {
-      if (!is_white_pawn(fst) && !is_white_king(fst)) {
-        to->insert({fst, snd});
-      } else if (is_white_king(fst)) {
-        sq_king = fst;
+  const uint64_t targets = ~us & check_mask & wanted;
+  // a pinned piece may only move along the line through it and the king
+  const auto pin_mask = [&](const Square sq) -> uint64_t {
+    if (pinned & bitboard::square(sq)) {
+      return Geometry::line[static_cast<int>(sq_king)][static_cast<int>(sq)];
+    }
+    return ~0ULL;
+  };
+
+  // a pinned knight can never stay on the line of the pin
+  for (uint64_t b = knights & ~pinned; b;) {
+    const Square sq = bitboard::pop_lsb(b);
+    sink.targets(sq, Attacks::knight[static_cast<int>(sq)] & targets, them);
+  }
+  for (uint64_t b = bishops; b;) {
+    const Square sq = bitboard::pop_lsb(b);
+    sink.targets(sq, Attacks::bishop(sq, occ) & targets & pin_mask(sq), them);
+  }
+  for (uint64_t b = rooks; b;) {
+    const Square sq = bitboard::pop_lsb(b);
+    sink.targets(sq, Attacks::rook(sq, occ) & targets & pin_mask(sq), them);
+  }
+  if (sink.done()) {
+    return in_check;
+  }
+
+  // pawns
+  constexpr int up = white ? 1 : -1;
+  constexpr uint64_t start_rank = white ? 0x000000000000FF00ULL  // rank 2
+                                        : 0x00FF000000000000ULL; // rank 7
+  const Square ept = game_state.en_passant_target;
+  bool en_passant = false;
+  if (ept != Square::none) {
+    // the pawn that just moved two squares sits behind the target
+    en_passant =
+        get_row(ept) == (white ? 6 : 3) &&
+        (enemy_pawns & bitboard::shift(bitboard::square(ept), 0, -up));
+  }
+  for (uint64_t b = pawns; b;) {
+    const Square sq = bitboard::pop_lsb(b);
+    const uint64_t from = bitboard::square(sq);
+    const uint64_t attacks =
+        Attacks::pawn[static_cast<int>(c)][static_cast<int>(sq)];
+
+    uint64_t pushes = bitboard::shift(from, 0, up) & ~occ;
+    if (pushes && (from & start_rank)) {
+      pushes |= bitboard::shift(pushes, 0, up) & ~occ;
+    }
+    // promotions count as captures, whether or not they take anything
+    uint64_t pawn_targets = (attacks & them) | pushes;
+    if (type == Gen_Type::captures) {
+      pawn_targets &= them | promotion_ranks;
+    } else if (type == Gen_Type::quiets) {
+      pawn_targets &= ~them & ~promotion_ranks;
+    }
+    sink.pawn_targets(sq, pawn_targets & check_mask & pin_mask(sq), them);
+
+    if (en_passant && type != Gen_Type::quiets &&
+        (attacks & bitboard::square(ept))) {
+      const uint64_t captured = bitboard::shift(bitboard::square(ept), 0, -up);
+      if (!(check_mask & (bitboard::square(ept) | captured))) {
+        continue;
       }
-    }
-  } else if (c == c::black) {
-    for (const auto &[fst, snd] : *from) {
-      if (!is_black_pawn(fst) && !is_black_king(fst)) {
-        to->insert({fst, snd});
-      } else if (is_black_king(fst)) {
-        sq_king = fst;
+      // two pawns leave the rank at once, so look for a discovered check
+      // directly rather than through the pin rays
+      if (king) {
+        const uint64_t after = (occ ^ from ^ captured) | bitboard::square(ept);
+        if ((Attacks::bishop(sq_king, after) & enemy_bishops) ||
+            (Attacks::rook(sq_king, after) & enemy_rooks)) {
+          continue;
+        }
       }
+      sink.move(Move(sq, ept, Move::en_passant));
     }
   }
-  return sq_king;
+  return in_check;
 }
 
-void Board::remove_same_color_squares(
-    const Color color,
-    std::unordered_map<Square, std::vector<Square>> *map) const {
-  std::unordered_map<Square, std::vector<Square>>
-      temp;                           // to reassign original after cleaning
-  std::vector<Square> temp_squares{}; // to store non-same-colored squares
-  temp_squares.reserve(16);
+template <Color Us>
+bool Board::generate_moves(MoveList *moves, const Gen_Type type) const {
+  List_Sink sink{moves};
+  return generate_legal<Us>(sink, type);
+}
+
+template <Color Us>
+void Board::generate_pseudo_legal(MoveList *moves, const Gen_Type type) const {
+  constexpr Color c = Us;
+  constexpr bool white = Us == Color::white;
+  constexpr Color enemy = white ? Color::black : Color::white;
+
+  const uint64_t us = occupied(c);
+  const uint64_t them = occupied(enemy);
+  const uint64_t occ = us | them;
+  const uint64_t wanted = type == Gen_Type::captures ? them
+                          : type == Gen_Type::quiets ? ~them
+                                                     : ~0ULL;
+  uint64_t check_mask = ~0ULL; // for evasions, squares that answer the check
 
-  for (const auto &[fst, snd] : *map) {
-    temp_squares.clear(); // reset temp vector
-    // record every non-same-colored square
-    for (const auto &sq : snd) {
-      if (!is_same_color(sq, color)) {
-        temp_squares.push_back(sq);
+  for (uint64_t b = pieces(c, Piece::king); b;) {
+    const Square sq = bitboard::pop_lsb(b);
+    const int k = static_cast<int>(sq);
+    push_moves(sq, Attacks::king[k] & ~us & wanted, them, moves);
+
+    if (type == Gen_Type::evasions) {
+      // only the king can get out of two checks at once
+      const uint64_t checkers = attackers_to(sq, occ) & them;
+      if (bitboard::count(checkers) > 1) {
+        return;
       }
-    }
-    temp.insert({fst, temp_squares}); // insert into "scrubbed" map
-  }
-  *map = temp; // reassign original map
-}
-
-void Board::update_move_maps() {
-  /**
-   * @brief Clear all the maps in a Maps object.
-   */
-  maps->clear();                    // clear move maps
-  game_state.white_inCheck = false; // reset check flags
-  game_state.black_inCheck = false;
-  update_influence_maps(); // update influence maps
-
-  // copy influence maps, exclude pawns and kings; we have a special treatment
-  // for them
-  const Square sq_w_King =
-      copy_influence(Color::white, &maps->white_influence, &maps->white_moves);
-  const Square sq_b_king =
-      copy_influence(Color::black, &maps->black_influence, &maps->black_moves);
-
-  update_pinned_pieces(); // update pinned pieces
-
-  // start reduction ------------------------------------
-  remove_same_color_squares(Color::white,
-                            &maps->white_moves); // remove same colored squares
-  remove_same_color_squares(Color::black,
-                            &maps->black_moves); // remove same colored squares
-
-  for (const auto &sq : maps->white_influence | std::views::keys) {
-    if (is_white_pawn(sq)) {
-      maps->white_moves.insert({sq, legal_moves(sq)});
-    } // generate white pawn moves
-  }
-  for (const auto &sq : maps->black_influence | std::views::keys) {
-    if (is_black_pawn(sq)) {
-      maps->black_moves.insert({sq, legal_moves(sq)});
-    } // generate black pawn moves
-  }
-
-  // generate king moves
-  // if king is in check, go through and "scrub" the move map
-  std::vector<Square> giving_check{};
-  std::vector<Square> blocking_squares{};
-
-  // white
-  giving_check = update_white_king_moves(sq_w_King);
-
-  // search for pinned pieces
-  // the piece can only move along the line of the pin
-  // if the king is in the same row or column as a rook or queen
-  // if the king is in the same diagonal as a bishop
-  // and there is only one friendly piece sharing that line - that piece is
-  // pinned the pieces movement must be restricted to the line of the pin there
-  // may be multiple lines of pinning
-
-  // find all the rows, columns, and diagonals that the king shares with
-  // opposite colored rooks, queens, and bishops
-
-  // if one piece is giving check, it can be captured or blocked
-  if (giving_check.size() == 1) {
-    // if it's not a knight or pawn, it might be able to be blocked
-    if (!is_knight(giving_check[0]) && !is_pawn(giving_check[0])) {
-      if (is_inSameRow(giving_check[0], sq_w_King)) {
-        for (auto sq = sq_w_King; sq != giving_check[0];
-             sq_w_King > giving_check[0] ? --sq : ++sq) {
-          blocking_squares.push_back(sq);
-        }
-      } else if (is_inSameColumn(giving_check[0], sq_w_King)) {
-        for (auto sq = sq_w_King; sq != giving_check[0];
-             sq_w_King > giving_check[0] ? sq = sq - 8 : sq = sq + 8) {
-          blocking_squares.push_back(sq);
-        }
-      } else if (is_inSameDiagonal_leftRight(giving_check[0], sq_w_King)) {
-        for (auto sq = sq_w_King; sq != giving_check[0];
-             sq_w_King > giving_check[0] ? sq = sq - 7 : sq = sq + 7) {
-          blocking_squares.push_back(sq);
-        }
-      } else if (is_inSameDiagonal_rightLeft(giving_check[0], sq_w_King)) {
-        for (auto sq = sq_w_King; sq != giving_check[0];
-             sq_w_King > giving_check[0] ? sq = sq - 9 : sq = sq + 9) {
-          blocking_squares.push_back(sq);
-        }
+      if (checkers) {
+        const int checker = static_cast<int>(bitboard::lsb(checkers));
+        check_mask = checkers | Geometry::between[k][checker];
       }
-    }
-    for (auto &[fst, snd] : maps->white_moves) {
-      if (!is_king(fst)) {
-        std::vector<Square> temp{};
-        for (const auto &sq : snd) {
-          for (const auto &block_sq : blocking_squares) {
-            if (sq == block_sq) {
-              temp.push_back(sq);
-            }
-          }
-          if (sq == giving_check[0]) {
-            temp.push_back(sq);
-          }
-        }
-        snd = temp;
+      continue;
+    }
+    // is_legal checks that the king does not castle out of, through or into
+    // check
+    constexpr int r = white ? 0 : 56;
+    const uint64_t own_rooks = pieces(c, Piece::rook);
+    if (k == r + 3 && type != Gen_Type::captures) {
+      if (game_state.can_castle(white ? Game_State::castle_w_K
+                                      : Game_State::castle_b_k) &&
+          (own_rooks & 1ULL << r) && !(occ & 0x06ULL << r)) {
+        moves->push_back(Move(sq, sq - 2, Move::king_castle));
+      }
+      if (game_state.can_castle(white ? Game_State::castle_w_Q
+                                      : Game_State::castle_b_q) &&
+          (own_rooks & 0x80ULL << r) && !(occ & 0x70ULL << r)) {
+        moves->push_back(Move(sq, sq + 2, Move::queen_castle));
       }
     }
   }
-  // if more than once piece is giving check, the king must be moved
-  else if (giving_check.size() > 1) {
-    // clear all moves except king evasion
-    for (auto &[fst, snd] : maps->white_moves) {
-      if (!is_king(fst)) {
-        snd.clear();
+  const uint64_t targets = ~us & wanted & check_mask;
+  for (uint64_t b = pieces(c, Piece::knight); b;) {
+    const Square sq = bitboard::pop_lsb(b);
+    push_moves(sq, Attacks::knight[static_cast<int>(sq)] & targets, them,
+               moves);
+  }
+  for (uint64_t b = pieces(c, Piece::bishop) | pieces(c, Piece::queen); b;) {
+    const Square sq = bitboard::pop_lsb(b);
+    push_moves(sq, Attacks::bishop(sq, occ) & targets, them, moves);
+  }
+  for (uint64_t b = pieces(c, Piece::rook) | pieces(c, Piece::queen); b;) {
+    const Square sq = bitboard::pop_lsb(b);
+    push_moves(sq, Attacks::rook(sq, occ) & targets, them, moves);
+  }
+
+  constexpr int up = white ? 1 : -1;
+  constexpr uint64_t start_rank = white ? 0x000000000000FF00ULL  // rank 2
+                                        : 0x00FF000000000000ULL; // rank 7
+  const uint64_t promotion_ranks = bitboard::RANK_1 | bitboard::RANK_8;
+  const Square ept = game_state.en_passant_target;
+  bool en_passant = false;
+  if (ept != Square::none && type != Gen_Type::quiets) {
+    // the pawn that just moved two squares sits behind the target, and
+    // taking it answers a check it gives
+    const uint64_t captured = bitboard::shift(bitboard::square(ept), 0, -up);
+    en_passant = get_row(ept) == (white ? 6 : 3) &&
+                 (pieces(enemy, Piece::pawn) & captured) &&
+                 (check_mask & (bitboard::square(ept) | captured));
+  }
+  for (uint64_t b = pieces(c, Piece::pawn); b;) {
+    const Square sq = bitboard::pop_lsb(b);
+    const uint64_t from = bitboard::square(sq);
+    const uint64_t attacks =
+        Attacks::pawn[static_cast<int>(c)][static_cast<int>(sq)];
+
+    uint64_t pushes = bitboard::shift(from, 0, up) & ~occ;
+    if (pushes && (from & start_rank)) {
+      pushes |= bitboard::shift(pushes, 0, up) & ~occ;
+    }
+    uint64_t pawn_targets = (attacks & them) | pushes;
+    if (type == Gen_Type::captures) {
+      pawn_targets &= them | promotion_ranks;
+    } else if (type == Gen_Type::quiets) {
+      pawn_targets &= ~them & ~promotion_ranks;
+    }
+    push_pawn_moves(sq, pawn_targets & check_mask, them, moves);
+    if (en_passant && (attacks & bitboard::square(ept))) {
+      moves->push_back(Move(sq, ept, Move::en_passant));
+    }
+  }
+}
+
+template <Color Us>
+void Board::generate_quiet_checks(MoveList *moves) const {
+  constexpr Color c = Us;
+  constexpr bool white = Us == Color::white;
+  constexpr Color enemy = white ? Color::black : Color::white;
+
+  const uint64_t enemy_king = pieces(enemy, Piece::king);
+  if (!enemy_king) {
+    return;
+  }
+  const Square sq_king = bitboard::lsb(enemy_king);
+  const int k = static_cast<int>(sq_king);
+  const uint64_t us = occupied(c);
+  const uint64_t them = occupied(enemy);
+  const uint64_t occ = us | them;
+  const uint64_t queens = pieces(c, Piece::queen);
+  const uint64_t bishops = pieces(c, Piece::bishop);
+  const uint64_t rooks = pieces(c, Piece::rook);
+
+  // our pieces that are all that stands between one of our sliders and the
+  // enemy king: moving one off the line uncovers a check
+  uint64_t discoverers = 0;
+  uint64_t snipers = (Attacks::bishop(sq_king, 0) & (bishops | queens)) |
+                     (Attacks::rook(sq_king, 0) & (rooks | queens));
+  while (snipers) {
+    const int sniper = static_cast<int>(bitboard::pop_lsb(snipers));
+    if (const uint64_t blockers = Geometry::between[k][sniper] & occ;
+        bitboard::count(blockers) == 1 && (blockers & us)) {
+      discoverers |= blockers;
+    }
+  }
+  // the empty squares from which a piece on sq gives check
+  const auto checks = [&](const Square sq, const uint64_t direct) {
+    uint64_t b = direct;
+    if (discoverers & bitboard::square(sq)) {
+      b |= ~Geometry::line[k][static_cast<int>(sq)];
+    }
+    return b & ~occ;
+  };
+
+  for (uint64_t b = pieces(c, Piece::knight); b;) {
+    const Square sq = bitboard::pop_lsb(b);
+    push_moves(sq,
+               Attacks::knight[static_cast<int>(sq)] &
+                   checks(sq, Attacks::knight[k]),
+               them, moves);
+  }
+  const uint64_t bishop_checks = Attacks::bishop(sq_king, occ);
+  const uint64_t rook_checks = Attacks::rook(sq_king, occ);
+  for (uint64_t b = bishops; b;) {
+    const Square sq = bitboard::pop_lsb(b);
+    push_moves(sq, Attacks::bishop(sq, occ) & checks(sq, bishop_checks), them,
+               moves);
+  }
+  for (uint64_t b = rooks; b;) {
+    const Square sq = bitboard::pop_lsb(b);
+    push_moves(sq, Attacks::rook(sq, occ) & checks(sq, rook_checks), them,
+               moves);
+  }
+  for (uint64_t b = queens; b;) {
+    const Square sq = bitboard::pop_lsb(b);
+    push_moves(sq,
+               Attacks::queen(sq, occ) &
+                   checks(sq, bishop_checks | rook_checks),
+               them, moves);
+  }
+  // the king can only check by discovery
+  for (uint64_t b = pieces(c, Piece::king); b;) {
+    const Square sq = bitboard::pop_lsb(b);
+    push_moves(sq, Attacks::king[static_cast<int>(sq)] & checks(sq, 0), them,
+               moves);
+  }
+
+  constexpr int up = white ? 1 : -1;
+  constexpr uint64_t start_rank = white ? 0x000000000000FF00ULL  // rank 2
+                                        : 0x00FF000000000000ULL; // rank 7
+  const uint64_t promotion_ranks = bitboard::RANK_1 | bitboard::RANK_8;
+  // a pawn checks from where a pawn of the king's color would attack ours
+  const uint64_t pawn_checks = Attacks::pawn[static_cast<int>(enemy)][k];
+  for (uint64_t b = pieces(c, Piece::pawn); b;) {
+    const Square sq = bitboard::pop_lsb(b);
+    const uint64_t from = bitboard::square(sq);
+    uint64_t pushes = bitboard::shift(from, 0, up) & ~occ;
+    if (pushes && (from & start_rank)) {
+      pushes |= bitboard::shift(pushes, 0, up) & ~occ;
+    }
+    push_pawn_moves(sq, pushes & ~promotion_ranks & checks(sq, pawn_checks),
+                    them, moves);
+  }
+}
+
+bool Board::is_legal(const Move move, const Check_Info &info) const {
+  const Square from = move.from();
+  const Square to = move.to();
+  const Color c = what_color(from);
+  Color enemy = c;
+  !enemy;
+  const uint64_t king = pieces(c, Piece::king);
+  if (!king) {
+    return true;
+  }
+  const Square sq_king = bitboard::lsb(king);
+  const int k = static_cast<int>(sq_king);
+  const uint64_t occ = occupied();
+
+  if (from == sq_king) {
+    // the king can't step back along a slider's ray, so lift it off the board
+    const uint64_t them = occupied(enemy);
+    if (move.is_castle()) {
+      // the king starts, passes and lands on the squares from and to span
+      uint64_t path = Geometry::between[k][static_cast<int>(to)] | king |
+                      bitboard::square(to);
+      while (path) {
+        if (attackers_to(bitboard::pop_lsb(path), occ & ~king) & them) {
+          return false;
+        }
       }
+      return true;
     }
+    return !(attackers_to(to, occ & ~king) & them);
   }
 
-  // black
-  giving_check.clear();
-  giving_check = update_black_king_moves(sq_b_king);
-  blocking_squares.clear(); // reset
-  // if one piece is giving check, it can be captured or blocked
-  if (giving_check.size() == 1) {
-    if (!is_knight(giving_check[0]) && !is_pawn(giving_check[0])) {
-      if (is_inSameRow(giving_check[0], sq_b_king)) {
-        for (auto sq = sq_b_king; sq != giving_check[0];
-             sq_b_king > giving_check[0] ? --sq : ++sq) {
-          blocking_squares.push_back(sq);
-        }
-      } else if (is_inSameColumn(giving_check[0], sq_b_king)) {
-        for (auto sq = sq_b_king; sq != giving_check[0];
-             sq_b_king > giving_check[0] ? sq = sq - 8 : sq = sq + 8) {
-          blocking_squares.push_back(sq);
-        }
-      } else if (is_inSameDiagonal_leftRight(giving_check[0], sq_b_king)) {
-        for (auto sq = sq_b_king; sq != giving_check[0];
-             sq_b_king > giving_check[0] ? sq = sq - 7 : sq = sq + 7) {
-          blocking_squares.push_back(sq);
-        }
-      } else if (is_inSameDiagonal_rightLeft(giving_check[0], sq_b_king)) {
-        for (auto sq = sq_b_king; sq != giving_check[0];
-             sq_b_king > giving_check[0] ? sq = sq - 9 : sq = sq + 9) {
-          blocking_squares.push_back(sq);
-        }
-      }
+  if (move.flags() == Move::en_passant) {
+    // two pawns leave the rank at once, so test the position after the move
+    const uint64_t captured = bitboard::square(get_row(to) == 6 ? to - 8
+                                                                : to + 8);
+    const uint64_t after =
+        (occ ^ bitboard::square(from) ^ captured) | bitboard::square(to);
+    return !(attackers_to(sq_king, after) & occupied(enemy) & ~captured);
+  }
+
+  if (info.checkers) {
+    // two checkers can't both be answered by one piece other than the king
+    if (bitboard::count(info.checkers) > 1) {
+      return false;
     }
-    for (auto &[fst, snd] : maps->black_moves) {
-      if (!is_king(fst)) {
-        std::vector<Square> temp{};
-        for (const auto &sq : snd) {
-          for (const auto &block_sq : blocking_squares) {
-            if (sq == block_sq) {
-              temp.push_back(sq);
-            }
-          }
-          if (sq == giving_check[0]) {
-            temp.push_back(sq);
-          }
-        }
-        snd = temp;
-      }
+    const int checker = static_cast<int>(bitboard::lsb(info.checkers));
+    if (!((info.checkers | Geometry::between[k][checker]) &
+          bitboard::square(to))) {
+      return false;
     }
   }
-  // if more than once piece is giving check, the king must be moved
-  else if (giving_check.size() > 1) {
-    // clear all moves except king evasion
-    for (auto &[fst, snd] : maps->black_moves) {
-      if (!is_king(fst)) {
-        snd.clear();
-      }
-    }
+  // a pinned piece may only move along the line through it and the king
+  return !(info.pinned & bitboard::square(from)) ||
+         (Geometry::line[k][static_cast<int>(from)] & bitboard::square(to));
+}
+
+bool Board::generate_moves(const Color c, MoveList *moves,
+                           const Gen_Type type) const {
+  return c == Color::white ? generate_moves<Color::white>(moves, type)
+                           : generate_moves<Color::black>(moves, type);
+}
+
+void Board::generate_pseudo_legal(const Color c, MoveList *moves,
+                                  const Gen_Type type) const {
+  if (c == Color::white) {
+    generate_pseudo_legal<Color::white>(moves, type);
+  } else {
+    generate_pseudo_legal<Color::black>(moves, type);
   }
+}
 
-  // pinned piece reduction
-  // white
-  for (const auto &[pinned, pinner] : maps->white_pinned) {
-    for (auto &[piece, moves] : maps->white_moves) {
-      if (piece == pinned) {
-        std::vector<Square> temp{};
-        for (auto &sq : moves) {
-          if (is_inSameRow(sq_w_King, pinner, sq)) {
-            temp.push_back(sq);
-          }
-          if (is_inSameColumn(sq_w_King, pinner, sq)) {
-            temp.push_back(sq);
-          }
-          if (is_inSameDiagonal_leftRight(sq_w_King, pinner, sq)) {
-            temp.push_back(sq);
-          }
-          if (is_inSameDiagonal_rightLeft(sq_w_King, pinner, sq)) {
-            temp.push_back(sq);
-          }
-        }
-        moves = temp;
-      }
-    }
+void Board::generate_quiet_checks(const Color c, MoveList *moves) const {
+  if (c == Color::white) {
+    generate_quiet_checks<Color::white>(moves);
+  } else {
+    generate_quiet_checks<Color::black>(moves);
   }
-  // black
-  for (const auto &[pinned, pinner] : maps->black_pinned) {
-    for (auto &[piece, moves] : maps->black_moves) {
-      if (piece == pinned) {
-        std::vector<Square> temp{};
-        for (auto &sq : moves) {
-          if (is_inSameRow(sq_b_king, pinner, sq)) {
-            temp.push_back(sq);
-          }
-          if (is_inSameColumn(sq_b_king, pinner, sq)) {
-            temp.push_back(sq);
-          }
-          if (is_inSameDiagonal_leftRight(sq_b_king, pinner, sq)) {
-            temp.push_back(sq);
-          }
-          if (is_inSameDiagonal_rightLeft(sq_b_king, pinner, sq)) {
-            temp.push_back(sq);
-          }
-        }
-        moves = temp;
-      }
-    }
+}
+
+unsigned Board::count_legal_moves(const Color c) const {
+  Count_Sink sink;
+  if (c == Color::white) {
+    generate_legal<Color::white>(sink, Gen_Type::all);
+  } else {
+    generate_legal<Color::black>(sink, Gen_Type::all);
+  }
+  return sink.count;
+}
+
+bool Board::has_legal_move(const Color c) const {
+  Any_Sink sink;
+  if (c == Color::white) {
+    generate_legal<Color::white>(sink, Gen_Type::all);
+  } else {
+    generate_legal<Color::black>(sink, Gen_Type::all);
   }
+  return sink.found;
+}
+
+MoveList Board::legal_moves(const Color c) const {
+  MoveList moves;
+  generate_moves(c, &moves);
+  return moves;
+}
+
+bool Board::in_check(const Color c) const {
+  const uint64_t king = pieces(c, Piece::king);
+  Color enemy = c;
+  !enemy;
+  return king && is_attacked(bitboard::lsb(king), enemy);
 }
 
 // END update move maps
@@ -1650,17 +1658,15 @@ void Board::move_pawn(Square from, Square to, const char ch) {
   else {
     if (is_white_pawn(from)) {
       if (static_cast<int>(to) - static_cast<int>(from) == 16) {
-        game_state.en_passant_target = Sq::square_to_string(from + 8);
-        game_state.en_passant_set = true;
-      } else if (Sq::square_to_string(to) == game_state.en_passant_target) {
-        remove_piece(Sq::string_to_square(game_state.en_passant_target) - 8);
+        game_state.en_passant_target = from + 8;
+      } else if (to == game_state.en_passant_target) {
+        remove_piece(to - 8);
       }
     } else if (is_black_pawn(from)) {
       if (static_cast<int>(from) - static_cast<int>(to) == 16) {
-        game_state.en_passant_target = Sq::square_to_string(from - 8);
-        game_state.en_passant_set = true;
-      } else if (Sq::square_to_string(to) == game_state.en_passant_target) {
-        remove_piece(Sq::string_to_square(game_state.en_passant_target) + 8);
+        game_state.en_passant_target = from - 8;
+      } else if (to == game_state.en_passant_target) {
+        remove_piece(to + 8);
       }
     }
 
@@ -1672,49 +1678,50 @@ void Board::move_pawn(Square from, Square to, const char ch) {
 }
 
 void Board::move_king(const Square from, const Square to) {
+  const Color c = what_color(from);
   bool castled = false;
 
   // check for castling
   if (is_white_king(from) && from == s::e1) {
-    if (game_state.castle_w_K && to == s::g1 && is_white_rook(s::h1)) {
+    if (game_state.can_castle(Game_State::castle_w_K) && to == s::g1 &&
+        is_white_rook(s::h1)) {
       remove_piece(to);
       place_piece(to, what_piece(from));
       remove_piece(from);
       move_rook(s::h1, s::f1);
       castled = true;
-      game_state.castle_w_K = game_state.castle_w_Q = false;
-    } else if (game_state.castle_w_Q && to == s::c1 && is_white_rook(s::a1)) {
+    } else if (game_state.can_castle(Game_State::castle_w_Q) && to == s::c1 &&
+               is_white_rook(s::a1)) {
       remove_piece(to);
       place_piece(to, what_piece(from));
       remove_piece(from);
       move_rook(s::a1, s::d1);
       castled = true;
-      game_state.castle_w_K = game_state.castle_w_Q = false;
     }
   }
   if (is_black_king(from) && from == s::e8) {
-    if (game_state.castle_b_k && to == s::g8 && is_black_rook(s::h8)) {
+    if (game_state.can_castle(Game_State::castle_b_k) && to == s::g8 &&
+        is_black_rook(s::h8)) {
       remove_piece(to);
       place_piece(to, what_piece(from));
       remove_piece(from);
       move_rook(s::h8, s::f8);
       castled = true;
-      game_state.castle_b_k = game_state.castle_b_q = false;
-    } else if (game_state.castle_b_q && to == s::c8 && is_black_rook(s::a8)) {
+    } else if (game_state.can_castle(Game_State::castle_b_q) && to == s::c8 &&
+               is_black_rook(s::a8)) {
       remove_piece(to);
       place_piece(to, what_piece(from));
       remove_piece(from);
       move_rook(s::a8, s::d8);
       castled = true;
-      game_state.castle_b_k = game_state.castle_b_q = false;
     }
   }
 
   // update castling rights
-  if (is_white_king(from)) {
-    game_state.castle_w_K = game_state.castle_w_Q = false;
-  } else if (is_black_king(from)) {
-    game_state.castle_b_k = game_state.castle_b_q = false;
+  if (c == Color::white) {
+    game_state.castling &= ~(Game_State::castle_w_K | Game_State::castle_w_Q);
+  } else {
+    game_state.castling &= ~(Game_State::castle_b_k | Game_State::castle_b_q);
   }
 
   // move piece
@@ -1727,14 +1734,14 @@ void Board::move_king(const Square from, const Square to) {
 
 void Board::move_rook(const Square from, const Square to) {
   // update castling rights
-  if (game_state.castle_b_q && from == s::a8 && is_black_rook(from)) {
-    game_state.castle_b_q = false;
-  } else if (game_state.castle_b_k && from == s::h8 && is_black_rook(from)) {
-    game_state.castle_b_k = false;
-  } else if (game_state.castle_w_Q && from == s::a1 && is_white_rook(from)) {
-    game_state.castle_w_Q = false;
-  } else if (game_state.castle_w_K && from == s::h1 && is_white_rook(from)) {
-    game_state.castle_w_K = false;
+  if (from == s::a8 && is_black_rook(from)) {
+    game_state.castling &= ~Game_State::castle_b_q;
+  } else if (from == s::h8 && is_black_rook(from)) {
+    game_state.castling &= ~Game_State::castle_b_k;
+  } else if (from == s::a1 && is_white_rook(from)) {
+    game_state.castling &= ~Game_State::castle_w_Q;
+  } else if (from == s::h1 && is_white_rook(from)) {
+    game_state.castling &= ~Game_State::castle_w_K;
   }
 
   // move piece
@@ -1752,6 +1759,8 @@ void Board::move_piece(const Square from, const Square to) {
 void Board::do_move(const Square from, const Square to, const char ch) {
   // game state updates
   // comes first because from and to will change occupants after the move
+  const Square en_passant_target = game_state.en_passant_target;
+  key ^= state_key(); // the pieces update the key as they move
   !game_state.active_color; // swap active color
   if (is_black(from)) {
     game_state.full_move_number++;
@@ -1768,15 +1777,15 @@ void Board::do_move(const Square from, const Square to, const char ch) {
   // update castling rights if capturing rook
   if (is_white_rook(to)) {
     if (to == s::h1) {
-      game_state.castle_w_K = false;
+      game_state.castling &= ~Game_State::castle_w_K;
     } else if (to == s::a1) {
-      game_state.castle_w_Q = false;
+      game_state.castling &= ~Game_State::castle_w_Q;
     }
   } else if (is_black_rook(to)) {
     if (to == s::h8) {
-      game_state.castle_b_k = false;
+      game_state.castling &= ~Game_State::castle_b_k;
     } else if (to == s::a8) {
-      game_state.castle_b_q = false;
+      game_state.castling &= ~Game_State::castle_b_q;
     }
   }
 
@@ -1791,26 +1800,173 @@ void Board::do_move(const Square from, const Square to, const char ch) {
     move_piece(from, to);
   } // for knights, bishops, queens
 
-  // en passant expires
-  if (!game_state.en_passant_set && !game_state.en_passant_target.empty()) {
-    game_state.en_passant_target.clear();
+  // en passant expires unless this move was a double push that set it again
+  if (game_state.en_passant_target == en_passant_target) {
+    game_state.en_passant_target = Square::none;
   }
-  if (game_state.en_passant_set) {
-    game_state.en_passant_set = false;
+  key ^= state_key();
+  assert(key == compute_key());
+}
+
+namespace {
+
+/// @return The square d steps from sq, +8 being one rank up
+constexpr Square offset(const Square sq, const int d) {
+  return static_cast<Square>(static_cast<int>(sq) + d);
+}
+
+/// castling rights lost when a piece moves from or to each square
+constexpr std::array<uint8_t, 64> castling_lost = [] {
+  std::array<uint8_t, 64> table{};
+  table[static_cast<int>(Square::h1)] = Game_State::castle_w_K;
+  table[static_cast<int>(Square::a1)] = Game_State::castle_w_Q;
+  table[static_cast<int>(Square::e1)] =
+      Game_State::castle_w_K | Game_State::castle_w_Q;
+  table[static_cast<int>(Square::h8)] = Game_State::castle_b_k;
+  table[static_cast<int>(Square::a8)] = Game_State::castle_b_q;
+  table[static_cast<int>(Square::e8)] =
+      Game_State::castle_b_k | Game_State::castle_b_q;
+  return table;
+}();
+
+} // namespace
+
+template <Color Us> void Board::make_move(const Move move) {
+  constexpr bool white = Us == Color::white;
+  constexpr int up = white ? 8 : -8;
+  constexpr int pawn = white ? 1 : 7;  // mailbox code of our pawn
+  constexpr int rook = white ? 4 : 10; // and of our rook
+  const Square from = move.from();
+  const Square to = move.to();
+  const int moving = mailbox_code(from);
+  const bool capture = mailbox_code(to) != 0;
+
+  key ^= state_key(); // the pieces update the key as they move
+  !game_state.active_color; // swap active color
+  if constexpr (!white) {
+    game_state.full_move_number++;
+  }
+  // 50 move rule: draw if no pawn move or capture for 50 moves
+  if (moving == pawn || capture) {
+    game_state.half_move_clock = 0;
+  } else {
+    game_state.half_move_clock++;
+  }
+  game_state.castling &= ~(castling_lost[static_cast<int>(from)] |
+                           castling_lost[static_cast<int>(to)]);
+  game_state.en_passant_target = Square::none;
+
+  remove_piece(from);
+  if (capture) {
+    remove_piece(to);
+  }
+  switch (move.flags()) {
+  case Move::double_push:
+    game_state.en_passant_target = offset(from, up);
+    break;
+  case Move::en_passant:
+    remove_piece(offset(to, -up));
+    break;
+  case Move::king_castle: // the rook jumps from h to f
+    remove_piece(offset(to, -1));
+    place_code(offset(to, 1), rook);
+    break;
+  case Move::queen_castle: // the rook jumps from a to d
+    remove_piece(offset(to, 2));
+    place_code(offset(to, -1), rook);
+    break;
+  default:
+    break;
+  }
+  // a promoted pawn becomes the knight, bishop, rook or queen after it
+  place_code(to, move.is_promotion() ? pawn + 1 + (move.flags() & 3) : moving);
+
+  key ^= state_key();
+  assert(key == compute_key());
+}
+
+template <Color Us> void Board::unmake_move(const Move move, const Undo &undo) {
+  constexpr bool white = Us == Color::white;
+  constexpr int up = white ? 8 : -8;
+  constexpr int pawn = white ? 1 : 7;  // mailbox code of our pawn
+  constexpr int rook = white ? 4 : 10; // and of our rook
+  const Square from = move.from();
+  const Square to = move.to();
+
+  !game_state.active_color; // the side that made the move
+  if constexpr (!white) {
+    game_state.full_move_number--;
+  }
+  game_state.en_passant_target = undo.en_passant_target;
+  game_state.half_move_clock = undo.half_move_clock;
+  game_state.castling = undo.castling;
+
+  // put the piece back, a promoted piece goes back as a pawn
+  const int moved = mailbox_code(to);
+  remove_piece(to);
+  place_code(from, move.is_promotion() ? pawn : moved);
+
+  // put back whatever was captured
+  switch (move.flags()) {
+  case Move::en_passant:
+    place_code(offset(to, -up), white ? 7 : 1);
+    break;
+  case Move::king_castle:
+    remove_piece(offset(to, 1));
+    place_code(offset(to, -1), rook);
+    break;
+  case Move::queen_castle:
+    remove_piece(offset(to, -1));
+    place_code(offset(to, 2), rook);
+    break;
+  default:
+    if (undo.captured) {
+      place_code(to, undo.captured);
+    }
+    break;
+  }
+  key = undo.key;
+  assert(key == compute_key());
+}
+
+Undo Board::do_move(const Move move) {
+  const Undo undo{key, game_state.en_passant_target, game_state.half_move_clock,
+                  static_cast<uint8_t>(mailbox_code(move.to())),
+                  game_state.castling};
+  if (is_white(move.from())) {
+    make_move<Color::white>(move);
+  } else {
+    make_move<Color::black>(move);
   }
+  return undo;
 }
 
+void Board::undo_move(const Move move, const Undo &undo) {
+  // the piece that moved is on its destination, pawns promoted or not
+  if (is_white(move.to())) {
+    unmake_move<Color::white>(move, undo);
+  } else {
+    unmake_move<Color::black>(move, undo);
+  }
+}
+
+template bool Board::generate_moves<Color::white>(MoveList *, Gen_Type) const;
+template bool Board::generate_moves<Color::black>(MoveList *, Gen_Type) const;
+template void Board::generate_pseudo_legal<Color::white>(MoveList *,
+                                                         Gen_Type) const;
+template void Board::generate_pseudo_legal<Color::black>(MoveList *,
+                                                         Gen_Type) const;
+template void Board::generate_quiet_checks<Color::white>(MoveList *) const;
+template void Board::generate_quiet_checks<Color::black>(MoveList *) const;
+template void Board::make_move<Color::white>(Move);
+template void Board::make_move<Color::black>(Move);
+template void Board::unmake_move<Color::white>(Move, const Undo &);
+template void Board::unmake_move<Color::black>(Move, const Undo &);
+
 // END move
 //------------------------------------------------------------------------------
 // BEGIN diagnostic
 
-uint Board::nodes_at_depth_1(const Color color) {
-  update_move_maps();
-  uint nodes{};
-  for (const auto &moves :
-       (color == Color::white ? maps->white_moves : maps->black_moves) |
-           std::views::values) {
-    nodes += moves.size();
-  }
-  return nodes;
+uint Board::nodes_at_depth_1(const Color color) const {
+  return legal_moves(color).size();
 }
@@ -0,0 +1,174 @@
+/*
+ *     ____              __          __          __
+ *    / __ \____ _____ _/ /_        / /_  ____  / /_
+ *   / /_/ / __ `/ __ `/ __ \______/ __ \/ __ \/ __/
+ *  / _, _/ /_/ / /_/ / /_/ /_____/ /_/ / /_/ / /_
+ * /_/ |_|\__,_/\__,_/_.___/     /_.___/\____/\__/
+ *
+ * Copyright (c) 2024 de-Manzanares
+ * This work is released under the MIT license.
+ *
+ */
+
+#include "Epd.h"
+
+#include <algorithm>
+#include <iterator>
+#include <thread>
+
+#if defined(_WIN32)
+Mapped_File::Mapped_File(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    return;
+  }
+  _buffer.assign(std::istreambuf_iterator<char>(in),
+                 std::istreambuf_iterator<char>());
+  _data = _buffer.data();
+  _size = _buffer.size();
+  _open = true;
+}
+
+Mapped_File::~Mapped_File() = default;
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+Mapped_File::Mapped_File(const std::string &path) {
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+  struct stat st {};
+  if (::fstat(fd, &st) == 0) {
+    _size = static_cast<std::size_t>(st.st_size);
+    _open = true;
+    if (_size > 0) {
+      void *p = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (p == MAP_FAILED) {
+        _size = 0;
+        _open = false;
+      } else {
+        _data = static_cast<const char *>(p);
+        // read front to back, once
+        ::madvise(p, _size, MADV_SEQUENTIAL);
+      }
+    }
+  }
+  ::close(fd); // the mapping stays valid
+}
+
+Mapped_File::~Mapped_File() {
+  if (_data != nullptr) {
+    ::munmap(const_cast<char *>(_data), _size);
+  }
+}
+#endif
+
+namespace {
+
+/// Parse the lines of one chunk, returning the number skipped as malformed
+std::size_t parse_lines(std::string_view text, std::vector<Board> &boards) {
+  std::size_t skipped = 0;
+  Board board;
+  while (!text.empty()) {
+    const std::size_t eol = std::min(text.find('\n'), text.size());
+    const std::string_view line = text.substr(0, eol);
+    text.remove_prefix(std::min(eol + 1, text.size()));
+
+    const std::size_t first = line.find_first_not_of(" \t\r");
+    if (first == std::string_view::npos || line[first] == '#') {
+      continue;
+    }
+    if (board.parse_fen(line) == 0) {
+      ++skipped;
+      continue;
+    }
+    boards.push_back(board);
+  }
+  return skipped;
+}
+
+} // namespace
+
+std::size_t Epd::parse(const std::string_view text, std::vector<Board> *boards,
+                       const uint threads) {
+  // cut the text into chunks of about the same size, each ending on a line
+  std::vector<std::string_view> chunks;
+  std::size_t start = 0;
+  const std::size_t n = std::max(threads, 1U);
+  for (std::size_t i = 1; i <= n && start < text.size(); ++i) {
+    std::size_t end = i == n ? text.size() : text.size() * i / n;
+    end = std::max(end, start);
+    end = std::min(text.find('\n', end), text.size());
+    chunks.push_back(text.substr(start, end - start));
+    start = end + 1;
+  }
+
+  std::vector<std::vector<Board>> parsed(chunks.size());
+  std::vector<std::size_t> skipped(chunks.size(), 0);
+  std::vector<std::thread> pool;
+  for (std::size_t i = 1; i < chunks.size(); ++i) {
+    pool.emplace_back(
+        [&, i] { skipped[i] = parse_lines(chunks[i], parsed[i]); });
+  }
+  if (!chunks.empty()) {
+    skipped[0] = parse_lines(chunks[0], parsed[0]); // this thread works too
+  }
+  for (std::thread &t : pool) {
+    t.join();
+  }
+
+  std::size_t total = 0;
+  std::size_t skipped_total = 0;
+  for (std::size_t i = 0; i < chunks.size(); ++i) {
+    total += parsed[i].size();
+    skipped_total += skipped[i];
+  }
+  boards->reserve(boards->size() + total);
+  for (const std::vector<Board> &chunk : parsed) {
+    boards->insert(boards->end(), chunk.begin(), chunk.end());
+  }
+  return skipped_total;
+}
+
+bool Epd::load(const std::string &path, std::vector<Board> *boards,
+               const uint threads) {
+  const Mapped_File file(path);
+  if (!file.is_open()) {
+    return false;
+  }
+  parse(file.text(), boards, threads);
+  return true;
+}
+
+Fen_Writer::Fen_Writer(const std::string &path)
+    : _file(path, std::ios::binary), _block(BLOCK) {}
+
+void Fen_Writer::write(const Board &board) {
+  if (BLOCK - _used <= Board::FEN_MAX) {
+    flush();
+  }
+  char *end = board.write_fen(_block.data() + _used);
+  *end++ = '\n';
+  _used = static_cast<std::size_t>(end - _block.data());
+}
+
+void Fen_Writer::flush() {
+  _file.write(_block.data(), static_cast<std::streamsize>(_used));
+  _used = 0;
+}
+
+bool Epd::save(const std::string &path, const std::vector<Board> &boards) {
+  Fen_Writer writer(path);
+  if (!writer.is_open()) {
+    return false;
+  }
+  for (const Board &board : boards) {
+    writer.write(board);
+  }
+  writer.flush();
+  return true;
+}
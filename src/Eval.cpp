@@ -50,62 +50,43 @@ double Eval::material_evaluation(const Node *n) {
 }
 
 int Eval::detect_stalemate_checkmate(const Node *n) {
-  uint number_of_moves = 0;
-
-  // count moves, white's turn
-  if (n->active_color() == Color::white) {
-    for (const auto &moves :
-         n->board()->maps->white_moves | std::views::values) {
-      number_of_moves += moves.size();
-    }
-    if (number_of_moves == 0) { // possibly stalemate or checkmate
-      if (n->board()->game_state.white_inCheck) { // white is in checkmate
-        return -1;
-      }
-      return 0; // if not checkmate then stalemate
-    }
-  }
-  // count moves, black's turn
-  if (n->active_color() == Color::black) {
-    for (const auto &moves :
-         n->board()->maps->black_moves | std::views::values) {
-      number_of_moves += moves.size();
-    }
-    if (number_of_moves == 0) { // possibly stalemate or checkmate
-      if (n->board()->game_state.black_inCheck) { // black is in checkmate
-        return 1;
-      }
-      return 0; // if not checkmate then stalemate
+  const Color c = n->active_color();
+  // no moves: possibly stalemate or checkmate
+  if (!n->board()->has_legal_move(c)) {
+    if (n->board()->in_check(c)) { // checkmate
+      return c == Color::white ? -1 : 1;
     }
+    return 0; // if not checkmate then stalemate
   }
   return 2; // neither stalemate nor checkmate
 }
 
 double Eval::mobility_evaluation(const Node *n) {
   double score = 0;
-  for (const auto &[sq, moves] : n->board()->maps->white_moves) {
-    if (!n->board()->is_white_king(sq)) {
-      score += static_cast<double>(moves.size());
-    }
+  // a promotion counts once, not once per piece
+  const auto counts = [n](const Move move) {
+    return !n->board()->is_king(move.from()) &&
+           (!move.is_promotion() || move.promotion_piece() == 'q');
+  };
+  for (const Move move : n->board()->legal_moves(Color::white)) {
+    score += counts(move);
   }
-  for (const auto &[sq, moves] : n->board()->maps->black_moves) {
-    if (!n->board()->is_black_king(sq)) {
-      score -= static_cast<double>(moves.size());
-    }
+  for (const Move move : n->board()->legal_moves(Color::black)) {
+    score -= counts(move);
   }
   return score * MOBILITY_MULTIPLIER;
 }
 
 double Eval::check_bonus(const Node *n) {
   double score = 0;
-  if (n->board()->game_state.white_inCheck) {
+  if (n->board()->in_check(Color::white)) {
     if (mat_advantage) {
       score -= CHECK_BONUS / M;
     } else {
       score -= CHECK_BONUS;
     }
   }
-  if (n->board()->game_state.black_inCheck) {
+  if (n->board()->in_check(Color::black)) {
     if (mat_advantage) {
       score += CHECK_BONUS / M;
     } else {
@@ -144,11 +125,7 @@ double Eval::stacked_pawns(const Node *n) {
   std::vector column_w(9, 0);
   std::vector column_b(9, 0);
 
-  for (const auto &sq : n->board()->maps->white_moves | std::views::keys) {
-    if (n->board()->is_white_pawn(sq)) {
-      pawn_w.push_back(sq);
-    }
-  }
+  pawn_w = bitboard::squares(n->board()->pieces(Color::white, Piece::pawn));
   for (const auto &p : pawn_w) {
     column_w[n->board()->get_column(p)] += 1;
   }
@@ -157,11 +134,7 @@ double Eval::stacked_pawns(const Node *n) {
       stacked_balance -= c - 1; // bad for white == good for black (-)
     }
   }
-  for (const auto &sq : n->board()->maps->black_moves | std::views::keys) {
-    if (n->board()->is_black_pawn(sq)) {
-      pawn_b.push_back(sq);
-    }
-  }
+  pawn_b = bitboard::squares(n->board()->pieces(Color::black, Piece::pawn));
   for (const auto &p : pawn_b) {
     column_b[n->board()->get_column(p)] += 1;
   }
@@ -197,15 +170,11 @@ double Eval::passed_pawns(const Node *n) {
     pawn_b.push_back(row);
   }
 
-  for (const auto &sq : n->board()->maps->white_moves | std::views::keys) {
-    if (n->board()->is_white_pawn(sq)) {
-      pawn_w[n->board()->get_column(sq)].push_back(sq);
-    }
+  for (const auto &sq : bitboard::squares(n->board()->pieces(Color::white, Piece::pawn))) {
+    pawn_w[n->board()->get_column(sq)].push_back(sq);
   }
-  for (const auto &sq : n->board()->maps->black_moves | std::views::keys) {
-    if (n->board()->is_black_pawn(sq)) {
-      pawn_b[n->board()->get_column(sq)].push_back(sq);
-    }
+  for (const auto &sq : bitboard::squares(n->board()->pieces(Color::black, Piece::pawn))) {
+    pawn_b[n->board()->get_column(sq)].push_back(sq);
   }
 
   for (auto i = 0 + 1; i < COLUMNS + 1; ++i) { // so that [i-1] and [i+1] are ok
@@ -263,11 +232,12 @@ double Eval::discourage_early_queen_movement(const Node *n) {
 }
 
 double Eval::simple_evaluation(const Node *n) {
-  if (detect_stalemate_checkmate(n) == -1 || // white is in checkmate
-      detect_stalemate_checkmate(n) == 1) {  // black is in checkmate
-    return 1000 * detect_stalemate_checkmate(n);
+  const int result = detect_stalemate_checkmate(n);
+  if (result == -1 || // white is in checkmate
+      result == 1) {  // black is in checkmate
+    return 1000 * result;
   }
-  if (detect_stalemate_checkmate(n) == 0) { // stalemate
+  if (result == 0) { // stalemate
     return 0;
   }
   return material_evaluation(n) + mobility_evaluation(n) + check_bonus(n) +
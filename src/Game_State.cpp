@@ -12,23 +12,21 @@
 
 #include "Game_State.h"
 
-#include <unordered_map>
-
 std::string Game_State::fen_castling_ability() const {
   std::string s;
-  if (!castle_w_K && !castle_w_Q && !castle_b_k && !castle_b_q) {
+  if (!castling) {
     s += '-';
   } else {
-    if (castle_w_K) {
+    if (can_castle(castle_w_K)) {
       s += 'K';
     }
-    if (castle_w_Q) {
+    if (can_castle(castle_w_Q)) {
       s += 'Q';
     }
-    if (castle_b_k) {
+    if (can_castle(castle_b_k)) {
       s += 'k';
     }
-    if (castle_b_q) {
+    if (can_castle(castle_b_q)) {
       s += 'q';
     }
   }
@@ -36,7 +34,9 @@ std::string Game_State::fen_castling_ability() const {
 }
 
 std::string Game_State::fen_en_passant_targets() const {
-  return en_passant_target.empty() ? "-" : en_passant_target;
+  return en_passant_target == Square::none
+             ? "-"
+             : Sq::square_to_string(en_passant_target);
 }
 
 std::string Game_State::fen_half_move_clock() const {
@@ -49,42 +49,28 @@ std::string Game_State::fen_full_move_number() const {
 
 void Game_State::clear() {
   half_move_clock = full_move_number = 0;
-  castle_w_K = castle_w_Q = castle_b_k = castle_b_q = false;
-  en_passant_target.clear();
+  castling = 0;
+  en_passant_target = Square::none;
 }
 
-void Game_State::set_castling_ability(const std::string &s) {
-  if (s == "-") {
-    castle_w_K = castle_w_Q = false;
-    castle_b_k = castle_b_q = false;
-  } else {
-    std::unordered_map<char, bool &> castling_map = {{'K', castle_w_K},
-                                                     {'Q', castle_w_Q},
-                                                     {'k', castle_b_k},
-                                                     {'q', castle_b_q}};
-    for (const auto &ch : s) {
-      for (auto &[key, value] : castling_map) {
-        if (ch == key) {
-          value = true;
-        }
-      }
+void Game_State::set_castling_ability(const std::string_view s) {
+  castling = 0;
+  for (const auto &ch : s) {
+    switch (ch) {
+    case 'K':
+      castling |= castle_w_K;
+      break;
+    case 'Q':
+      castling |= castle_w_Q;
+      break;
+    case 'k':
+      castling |= castle_b_k;
+      break;
+    case 'q':
+      castling |= castle_b_q;
+      break;
+    default:
+      break;
     }
   }
 }
-
-Game_State &Game_State::operator=(const Game_State &rhs) {
-  if (this != &rhs) {
-    active_color = rhs.active_color;
-    castle_w_K = rhs.castle_w_K;
-    castle_w_Q = rhs.castle_w_Q;
-    castle_b_k = rhs.castle_b_k;
-    castle_b_q = rhs.castle_b_q;
-    en_passant_target = rhs.en_passant_target;
-    en_passant_set = rhs.en_passant_set;
-    half_move_clock = rhs.half_move_clock;
-    full_move_number = rhs.full_move_number;
-    black_inCheck = rhs.black_inCheck;
-    white_inCheck = rhs.white_inCheck;
-  }
-  return *this;
-}
@@ -0,0 +1,175 @@
+/*
+ *     ____              __          __          __
+ *    / __ \____ _____ _/ /_        / /_  ____  / /_
+ *   / /_/ / __ `/ __ `/ __ \______/ __ \/ __ \/ __/
+ *  / _, _/ /_/ / /_/ / /_/ /_____/ /_/ / /_/ / /_
+ * /_/ |_|\__,_/\__,_/_.___/     /_.___/\____/\__/
+ *
+ * Copyright (c) 2024 de-Manzanares
+ * This work is released under the MIT license.
+ *
+ */
+
+#include "Move_Picker.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+/// rough material value of each Piece, the king never being captured
+constexpr std::array<int, 7> VALUE = {1, 3, 3, 5, 9, 0, 0};
+
+/// @return True if move is in the list
+bool contains(const MoveList &moves, const Move move) {
+  return std::find(moves.begin(), moves.end(), move) != moves.end();
+}
+
+} // namespace
+
+Move_Picker::Move_Picker(const Board &board, const Move hash_move,
+                         const std::array<Move, 2> killers)
+    : _board(board), _info(board.check_info(board.game_state.active_color)),
+      _hash_move(hash_move), _killers(killers) {}
+
+const MoveList &Move_Picker::captures() {
+  if (!_have_captures) {
+    _board.generate_pseudo_legal(
+        _board.game_state.active_color, &_captures,
+        _info.checkers ? Gen_Type::evasions : Gen_Type::captures);
+    _have_captures = true;
+  }
+  return _captures;
+}
+
+const MoveList &Move_Picker::quiets() {
+  if (!_have_quiets) {
+    _board.generate_pseudo_legal(_board.game_state.active_color, &_quiets,
+                                 Gen_Type::quiets);
+    _have_quiets = true;
+  }
+  return _quiets;
+}
+
+int Move_Picker::score(const Move move) const {
+  const Piece attacker = _board.piece_on(move.from());
+  const Piece victim = move.flags() == Move::en_passant
+                           ? Piece::pawn
+                           : _board.piece_on(move.to());
+  int s = 16 * VALUE[static_cast<int>(victim)] -
+          VALUE[static_cast<int>(attacker)];
+  if (move.is_promotion()) {
+    // the promoted piece is won as if it were captured
+    s += 16 * (VALUE[static_cast<int>(Piece::knight) + (move.flags() & 3)] -
+               VALUE[static_cast<int>(Piece::pawn)]);
+  }
+  return s;
+}
+
+Move Move_Picker::pick_best() {
+  // selection sort, one step at a time: most moves are never reached
+  unsigned best = _index;
+  for (unsigned i = _index + 1; i < _captures.size(); ++i) {
+    if (_scores[i] > _scores[best]) {
+      best = i;
+    }
+  }
+  std::swap(_captures[_index], _captures[best]);
+  std::swap(_scores[_index], _scores[best]);
+  return _captures[_index++];
+}
+
+bool Move_Picker::given_early(const Move move) const {
+  return move == _hash_move || move == _killers[0] || move == _killers[1];
+}
+
+Move Move_Picker::next() {
+  switch (_stage) {
+  case Stage::hash:
+    _stage = Stage::captures_init;
+    if (_hash_move != Move::none()) {
+      const bool tactical = _info.checkers || _hash_move.is_capture() ||
+                            _hash_move.is_promotion();
+      if (contains(tactical ? captures() : quiets(), _hash_move) &&
+          _board.is_legal(_hash_move, _info)) {
+        return _hash_move;
+      }
+      _hash_move = Move::none();
+    }
+    [[fallthrough]];
+
+  case Stage::captures_init:
+    captures();
+    for (unsigned i = 0; i < _captures.size(); ++i) {
+      _scores[i] = score(_captures[i]);
+    }
+    _stage = _info.checkers ? Stage::evasions : Stage::captures;
+    _index = 0;
+    return next();
+
+  case Stage::captures:
+    while (_index < _captures.size()) {
+      const Move move = pick_best();
+      if (move == _hash_move || !_board.is_legal(move, _info)) {
+        continue;
+      }
+      // captures that lose material wait until after the quiet moves
+      if (!_board.see_ge(move, 0)) {
+        _bad_captures.push_back(move);
+        continue;
+      }
+      return move;
+    }
+    _stage = Stage::killers;
+    _index = 0;
+    [[fallthrough]];
+
+  case Stage::killers:
+    while (_index < _killers.size()) {
+      const Move killer = _killers[_index++];
+      const bool repeat =
+          killer == _hash_move || (_index == 2 && killer == _killers[0]);
+      if (killer != Move::none() && !repeat && contains(quiets(), killer) &&
+          _board.is_legal(killer, _info)) {
+        return killer;
+      }
+    }
+    _stage = Stage::quiets;
+    _index = 0;
+    [[fallthrough]];
+
+  case Stage::quiets:
+    quiets();
+    while (_index < _quiets.size()) {
+      const Move move = _quiets[_index++];
+      if (!given_early(move) && _board.is_legal(move, _info)) {
+        return move;
+      }
+    }
+    _stage = Stage::bad_captures;
+    _index = 0;
+    [[fallthrough]];
+
+  case Stage::bad_captures:
+    if (_index < _bad_captures.size()) {
+      return _bad_captures[_index++];
+    }
+    _stage = Stage::done;
+    [[fallthrough]];
+
+  case Stage::done:
+    break;
+
+  case Stage::evasions:
+    // in check there are few moves, all generated at once, captures first
+    while (_index < _captures.size()) {
+      const Move move = pick_best();
+      if (move != _hash_move && _board.is_legal(move, _info)) {
+        return move;
+      }
+    }
+    _stage = Stage::done;
+    break;
+  }
+  return Move::none();
+}
@@ -31,14 +31,10 @@ Node::Node(const std::string &fen) : _board(std::make_shared<Board>()) {
   _promotion = 0;
 }
 
-Node::Node(const std::shared_ptr<Board> &board, const Square from,
-           const Square to, const char ch)
-    : _board(std::make_shared<Board>()) {
-  *_board = *board;
-  _from = from;
-  _to = to;
-  _promotion = ch;
-  _board->do_move(from, to, ch);
+Node::Node(const Move move) {
+  _from = move.from();
+  _to = move.to();
+  _promotion = move.promotion_piece();
 }
 
 uint Node::count_nodes() { // NOLINT
@@ -51,50 +47,39 @@ uint Node::count_nodes() { // NOLINT
 
 void Node::spawn_depth_first(const uint depth) { // NOLINT
   if (depth == 0) {                              // terminal nodes
-    _board->update_move_maps();
     _eval = Eval::eval(this);
     _board.reset();
     return;
   }
 
-  _board->update_move_maps();
+  const MoveList moves = _board->legal_moves(_board->game_state.active_color);
 
   // not at specified depth, but still a terminal node
-  if (Eval::detect_stalemate_checkmate(this) != 2) { // 2 means neither
-    _eval = Eval::eval(this);                        // stalemate nor checkmate
+  if (moves.empty()) { // stalemate or checkmate
+    _eval = Eval::eval(this);
     _board.reset();
     return;
   }
 
-  for (const auto &[sq, moves] : _board->game_state.active_color == Color::white
-                                     ? _board->maps->white_moves
-                                     : _board->maps->black_moves) {
-    for (const auto &move : moves) {
-      if ((_board->get_row(move) == 8 && _board->is_white_pawn(sq)) ||
-          (_board->get_row(move) == 1 && _board->is_black_pawn(sq))) {
-        for (const auto piece : std::vector{'q', 'r', 'b', 'n'}) {
-          auto spawn = std::make_shared<Node>(Node(_board, sq, move, piece));
-          spawn->_parent = this;
-          _child.push_back(spawn);
-          Counter::node++;
-        }
-      } else {
-        auto spawn = std::make_shared<Node>(Node(_board, sq, move, 0));
-        spawn->_parent = this;
-        _child.push_back(spawn);
-        Counter::node++;
-      }
-    }
+  for (const Move move : moves) {
+    auto spawn = std::make_shared<Node>(move);
+    spawn->_parent = this;
+    _child.push_back(spawn);
+    Counter::node++;
   }
 
   // auto now = std::chrono::high_resolution_clock::now();
   // auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now
   // - Counter::start).count(); if (elapsed_ms > 15000) { return; }
 
-  _board.reset();
+  // every node below this one works on the same board
+  const std::shared_ptr<Board> board = std::move(_board);
 
-  for (const auto &n : _child) {
-    n->spawn_depth_first(depth - 1);
+  for (uint i = 0; i < moves.size(); ++i) {
+    const Undo undo = board->do_move(moves[i]);
+    _child[i]->_board = board;
+    _child[i]->spawn_depth_first(depth - 1);
+    board->undo_move(moves[i], undo);
   }
 }
 
@@ -0,0 +1,216 @@
+/*
+ *     ____              __          __          __
+ *    / __ \____ _____ _/ /_        / /_  ____  / /_
+ *   / /_/ / __ `/ __ `/ __ \______/ __ \/ __ \/ __/
+ *  / _, _/ /_/ / /_/ / /_/ /_____/ /_/ / /_/ / /_
+ * /_/ |_|\__,_/\__,_/_.___/     /_.___/\____/\__/
+ *
+ * Copyright (c) 2024 de-Manzanares
+ * This work is released under the MIT license.
+ *
+ */
+
+#include "Perft.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+Perft_Table::Perft_Table(const std::size_t megabytes) {
+  std::size_t size = 1;
+  while (size * 2 * sizeof(Entry) <= megabytes << 20) {
+    size *= 2;
+  }
+  _entries = std::vector<Entry>(size);
+}
+
+uint64_t Perft_Table::lock(const uint64_t key, const uint depth) {
+  // mix() below 64 is not used by any Zobrist key
+  return key ^ zobrist::mix(depth % 64);
+}
+
+bool Perft_Table::probe(const uint64_t key, const uint depth,
+                        uint64_t *nodes) const {
+  const uint64_t k = lock(key, depth);
+  const Entry &entry = _entries[k & (_entries.size() - 1)];
+  const uint64_t n = entry.nodes.load(std::memory_order_relaxed);
+  if ((entry.check.load(std::memory_order_relaxed) ^ n) != k) {
+    return false;
+  }
+  *nodes = n;
+  return true;
+}
+
+void Perft_Table::store(const uint64_t key, const uint depth,
+                        const uint64_t nodes) {
+  const uint64_t k = lock(key, depth);
+  Entry &entry = _entries[k & (_entries.size() - 1)];
+  entry.check.store(k ^ nodes, std::memory_order_relaxed);
+  entry.nodes.store(nodes, std::memory_order_relaxed);
+}
+
+void Perft_Table::record(const uint64_t probes, const uint64_t hits) {
+  _probes += probes;
+  _hits += hits;
+}
+
+double Perft_Table::hit_rate() const {
+  const uint64_t probes = _probes;
+  return probes ? static_cast<double>(_hits) / static_cast<double>(probes) : 0;
+}
+
+namespace {
+
+/**
+ * @brief Perft::count with the table, counting probes and hits as it goes
+ * @details Only subtrees of two plies or more go in the table; one ply is
+ * bulk counted faster than it could be looked up.
+ */
+uint64_t count_hashed(Board &board, const uint depth, // NOLINT
+                      Perft_Table &table, uint64_t &probes, uint64_t &hits) {
+  if (depth < 2) {
+    return Perft::count(board, depth);
+  }
+  uint64_t nodes = 0;
+  ++probes;
+  if (table.probe(board.key, depth, &nodes)) {
+    ++hits;
+    return nodes;
+  }
+  for (const Move move : board.legal_moves(board.game_state.active_color)) {
+    const Undo undo = board.do_move(move);
+    nodes += count_hashed(board, depth - 1, table, probes, hits);
+    board.undo_move(move, undo);
+  }
+  table.store(board.key, depth, nodes);
+  return nodes;
+}
+
+/// A subtree to count, with the position at its top
+struct Task {
+  Board board;    ///< the position after the moves leading here
+  uint depth;     ///< plies left to count below board
+  unsigned root;  ///< index of the root move this subtree is under
+  uint64_t nodes; ///< leaf nodes counted in the subtree
+};
+
+/**
+ * @brief Count the leaf nodes below each root move, using several threads
+ * @param board The position to count from
+ * @param depth The number of plies to look ahead, at least 1
+ * @param threads The number of worker threads, the calling thread included
+ * @param roots The legal moves of board
+ * @param table If given, subtree counts are shared between the threads here
+ * @return The number of leaf nodes below each root move
+ */
+std::vector<uint64_t> count_roots(const Board &board, const uint depth,
+                                  const uint threads, const MoveList &roots,
+                                  Perft_Table *table) {
+  // a few tasks per thread evens out subtrees of different sizes
+  const std::size_t enough = 8 * static_cast<std::size_t>(threads);
+
+  std::vector<Task> tasks;
+  for (unsigned i = 0; i < roots.size(); ++i) {
+    tasks.push_back({board, depth - 1, i, 0});
+    tasks.back().board.do_move(roots[i]);
+  }
+  // split one ply deeper while there are too few tasks, keeping at least two
+  // plies in each so the bulk counting at the last ply still pays off
+  while (tasks.size() < enough && !tasks.empty() && tasks.front().depth > 2) {
+    std::vector<Task> deeper;
+    for (Task &task : tasks) {
+      const Color c = task.board.game_state.active_color;
+      for (const Move move : task.board.legal_moves(c)) {
+        deeper.push_back({task.board, task.depth - 1, task.root, 0});
+        deeper.back().board.do_move(move);
+      }
+    }
+    tasks = std::move(deeper);
+  }
+
+  std::atomic<std::size_t> next = 0;
+  const auto worker = [&tasks, &next, table] {
+    for (std::size_t i; (i = next.fetch_add(1)) < tasks.size();) {
+      tasks[i].nodes = Perft::count(tasks[i].board, tasks[i].depth, table);
+    }
+  };
+  std::vector<std::thread> pool;
+  for (uint i = 1; i < threads; ++i) {
+    pool.emplace_back(worker);
+  }
+  worker(); // this thread works too
+  for (std::thread &t : pool) {
+    t.join();
+  }
+
+  std::vector<uint64_t> nodes(roots.size(), 0);
+  for (const Task &task : tasks) {
+    nodes[task.root] += task.nodes;
+  }
+  return nodes;
+}
+
+} // namespace
+
+uint64_t Perft::count(Board &board, const uint depth, // NOLINT
+                      Perft_Table *table) {
+  if (table != nullptr) {
+    uint64_t probes = 0;
+    uint64_t hits = 0;
+    const uint64_t nodes = count_hashed(board, depth, *table, probes, hits);
+    table->record(probes, hits);
+    return nodes;
+  }
+  if (depth == 0) {
+    return 1;
+  }
+  if (depth == 1) {
+    return board.count_legal_moves(board.game_state.active_color);
+  }
+  uint64_t nodes = 0;
+  for (const Move move : board.legal_moves(board.game_state.active_color)) {
+    const Undo undo = board.do_move(move);
+    nodes += count(board, depth - 1);
+    board.undo_move(move, undo);
+  }
+  return nodes;
+}
+
+uint64_t Perft::count(const Board &board, const uint depth,
+                      const uint threads, Perft_Table *table) {
+  if (depth == 0) {
+    return 1;
+  }
+  const MoveList roots = board.legal_moves(board.game_state.active_color);
+  uint64_t nodes = 0;
+  for (const uint64_t below :
+       count_roots(board, depth, threads, roots, table)) {
+    nodes += below;
+  }
+  return nodes;
+}
+
+uint64_t Perft::divide(Board &board, const uint depth, std::ostream &out,
+                       const uint threads, Perft_Table *table) {
+  const auto start = std::chrono::steady_clock::now();
+  const MoveList roots = board.legal_moves(board.game_state.active_color);
+  const std::vector<uint64_t> below =
+      count_roots(board, depth, threads, roots, table);
+  uint64_t nodes = 0;
+  for (unsigned i = 0; i < roots.size(); ++i) {
+    out << roots[i].uci() << ": " << below[i] << '\n';
+    nodes += below[i];
+  }
+  const auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+
+  out << "\nNodes searched: " << nodes << "\nTime: " << us / 1000 << " ms"
+      << "\nNPS: " << (us > 0 ? nodes * 1'000'000 / us : nodes);
+  if (table != nullptr) {
+    out << "\nHash hit rate: " << 100 * table->hit_rate() << '%';
+  }
+  out << std::endl;
+  return nodes;
+}
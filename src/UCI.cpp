@@ -12,8 +12,10 @@
 
 #include "UCI.h"
 #include "Eval.h"
+#include "Perft.h"
 #include "Search.h"
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <ranges>
@@ -98,7 +100,9 @@ void preamble(const std::string *in) {
   // should give engine options to be configured ... we don't have any right
   // now, so ... uciok!
   if (*in == "uci") {
-    std::cout << "id name Raab-bot\nid author Schauss\nuciok\n";
+    std::cout << "id name Raab-bot\nid author Schauss\n"
+              << "info string slider attacks " << Attacks::backend_name()
+              << "\nuciok\n";
   }
 
   // to give the engine time to set up stuff ... but we don't have any stuff!!!
@@ -157,7 +161,6 @@ void uci::loop() {
       Counter::node = 0;                   // reset counter
       ulp::continue_status_updates = true; // reset flag
       const bool maxing = ulp::is_maxing(n);
-      n->board()->update_move_maps();
 
       if (uciloop::simon_says(&in, "wtime")) { // get times
         std::istringstream iss(in);
@@ -180,15 +183,9 @@ void uci::loop() {
         }
       }
 
-      double movecount = 0;
-      for (const auto &moves :
-           n->board()->maps->white_moves | std::views::values) {
-        movecount += static_cast<double>(moves.size());
-      }
-      for (const auto &moves :
-           n->board()->maps->black_moves | std::views::values) {
-        movecount += static_cast<double>(moves.size());
-      }
+      const auto movecount =
+          static_cast<double>(n->board()->legal_moves(Color::white).size() +
+                              n->board()->legal_moves(Color::black).size());
       // complexity switch
       double NODE_LIMIT;
       // set time limit based on time control
@@ -242,6 +239,17 @@ void uci::loop() {
 
       n.reset();
 
+    } else if (ulp::simon_says(&in, "perft")) {
+      // not part of UCI: "perft <depth> [threads]" counts the leaf nodes below
+      // the current position, or below the starting position if none is set up
+      std::istringstream iss(in);
+      std::string s;
+      uint depth = 1;
+      uint threads = 1;
+      iss >> s >> depth >> threads;
+      Board board =
+          n != nullptr && n->board() != nullptr ? *n->board() : Board{};
+      Perft::divide(board, std::max(depth, 1U), std::cout, threads);
     } else if (in.find("stop") != std::string::npos) {
     } else if (in == "quit") {
       break;
@@ -0,0 +1,60 @@
+/*
+ *     ____              __          __          __
+ *    / __ \____ _____ _/ /_        / /_  ____  / /_
+ *   / /_/ / __ `/ __ `/ __ \______/ __ \/ __ \/ __/
+ *  / _, _/ /_/ / /_/ / /_/ /_____/ /_/ / /_/ / /_
+ * /_/ |_|\__,_/\__,_/_.___/     /_.___/\____/\__/
+ *
+ * Copyright (c) 2024 de-Manzanares
+ * This work is released under the MIT license.
+ *
+ */
+
+#include "../include/Perft.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+// usage: perft [-t threads] [-H megabytes] <depth> [fen]
+// counts from the starting position if no FEN is given, on every hardware
+// thread unless told otherwise, with a hash table only if given a size
+int main(int argc, char *argv[]) {
+  uint threads = std::max(std::thread::hardware_concurrency(), 1U);
+  std::size_t megabytes = 0;
+  while (argc > 2 && argv[1][0] == '-') {
+    if (std::string(argv[1]) == "-t") {
+      threads = std::max(static_cast<uint>(std::stoul(argv[2])), 1U);
+    } else if (std::string(argv[1]) == "-H") {
+      megabytes = std::stoul(argv[2]);
+    } else {
+      break;
+    }
+    argc -= 2;
+    argv += 2;
+  }
+  if (argc < 2 || argv[1][0] == '-' || std::stoul(argv[1]) == 0) {
+    std::cerr << "usage: perft [-t threads] [-H megabytes] <depth> [fen]\n";
+    return EXIT_FAILURE;
+  }
+  const auto depth = static_cast<uint>(std::stoul(argv[1]));
+
+  Board board;
+  if (argc > 2) {
+    std::string fen = argv[2];
+    for (int i = 3; i < argc; ++i) { // an unquoted FEN arrives in pieces
+      fen += ' ';
+      fen += argv[i];
+    }
+    board.import_fen(fen);
+  }
+  if (megabytes > 0) {
+    Perft_Table table(megabytes);
+    Perft::divide(board, depth, std::cout, threads, &table);
+  } else {
+    Perft::divide(board, depth, std::cout, threads);
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,53 @@
+#include "../../include/Attack_Map.h"
+#include <catch2/catch_all.hpp>
+
+// walk the move tree, checking the updated map against one built from scratch
+bool walk(Board &board, Attack_Map &map, const uint depth) {
+  if (!(map == Attack_Map(board))) {
+    return false;
+  }
+  if (depth == 0) {
+    return true;
+  }
+  for (const Move move : board.legal_moves(board.game_state.active_color)) {
+    const Undo undo = board.do_move(move);
+    map.update(board);
+    const bool ok = walk(board, map, depth - 1);
+    board.undo_move(move, undo);
+    map.update(board);
+    if (!ok || !(map == Attack_Map(board))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+TEST_CASE("attack map") {
+  Board board;
+  SECTION("start position") {
+    const Attack_Map map(board);
+    CHECK(map.attacks(Color::white) == 0x0000000000FFFF7EULL);
+    CHECK(map.count(Color::white, Square::f3) == 3); // pawns e2, g2, knight
+    CHECK(map.count(Color::black, Square::f3) == 0);
+    CHECK(map.attacks_from(Square::b1) ==
+          (bitboard::square(Square::a3) | bitboard::square(Square::c3) |
+           bitboard::square(Square::d2)));
+    CHECK(!map.in_check(Color::white));
+  }
+  SECTION("incremental updates match a full rebuild") {
+    for (const std::string fen :
+         {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+          "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+          "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1"}) {
+      board.import_fen(fen);
+      Attack_Map map(board);
+      CHECK(walk(board, map, 3));
+    }
+  }
+  SECTION("check") {
+    board.import_fen("4k3/8/8/8/8/8/4q3/4K3 w - - 0 1");
+    const Attack_Map map(board);
+    CHECK(map.in_check(Color::white));
+    CHECK(map.in_check(Color::white) == board.in_check(Color::white));
+  }
+}
@@ -4,28 +4,47 @@
 
 void generate_and_sort_bmt(Board &board, const Square &sq,
                            std::vector<Square> &v) {
-  board.update_move_maps();
   Color c = board.what_color(sq);
   if (c == Color::white) {
-    v = board.maps->white_moves[sq];
+    v.clear();
+    for (const Move move : board.legal_moves(Color::white)) {
+      if (move.from() == sq &&
+          (!move.is_promotion() || move.promotion_piece() == 'q')) {
+        v.push_back(move.to()); // one entry per promotion square
+      }
+    }
   }
   if (c == Color::black) {
-    v = board.maps->black_moves[sq];
+    v.clear();
+    for (const Move move : board.legal_moves(Color::black)) {
+      if (move.from() == sq &&
+          (!move.is_promotion() || move.promotion_piece() == 'q')) {
+        v.push_back(move.to()); // one entry per promotion square
+      }
+    }
   }
   std::sort(v.begin(), v.end());
 }
 
 void generate_and_sort_white_king(Board &board, const Square &sq,
                                   std::vector<Square> &v) {
-  board.update_move_maps();
-  v = board.maps->white_moves[sq];
+  v.clear();
+  for (const Move move : board.legal_moves(Color::white)) {
+    if (move.from() == sq) {
+      v.push_back(move.to());
+    }
+  }
   std::sort(v.begin(), v.end());
 }
 
 void generate_and_sort_black_king(Board &board, const Square &sq,
                                   std::vector<Square> &v) {
-  board.update_move_maps();
-  v = board.maps->black_moves[sq];
+  v.clear();
+  for (const Move move : board.legal_moves(Color::black)) {
+    if (move.from() == sq) {
+      v.push_back(move.to());
+    }
+  }
   std::sort(v.begin(), v.end());
 }
 
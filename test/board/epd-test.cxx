@@ -0,0 +1,113 @@
+#include "../../include/Epd.h"
+#include <catch2/catch_all.hpp>
+
+#include <cstdio>
+#include <fstream>
+
+TEST_CASE("parse fen") {
+  Board board;
+  SECTION("round trip") {
+    for (const std::string fen :
+         {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+          "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+          "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+          "rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR b KQkq d6 0 3",
+          "4k3/8/8/8/8/8/8/4K3 b - - 42 97"}) {
+      CHECK(board.parse_fen(fen) == fen.size());
+      CHECK(board.export_fen() == fen);
+    }
+  }
+  SECTION("stops at the end of the position") {
+    const std::string_view line =
+        "4k3/8/8/8/8/8/8/4K3 w - - 0 1 bm Kd2; id \"x\";";
+    CHECK(board.parse_fen(line) == 29);
+    CHECK(board.export_fen() == "4k3/8/8/8/8/8/8/4K3 w - - 0 1");
+  }
+  SECTION("clocks are optional") {
+    CHECK(board.parse_fen("4k3/8/8/8/8/8/8/4K3 b - - bm Kd7;") > 0);
+    CHECK(board.export_fen() == "4k3/8/8/8/8/8/8/4K3 b - - 0 1");
+  }
+  SECTION("malformed") {
+    for (const std::string_view fen :
+         {"", "4k3/8/8/8/8/8/8 w - - 0 1", "4k3/8/8/8/8/8/8/4K4 w - - 0 1",
+          "4k3/8/8/8/8/8/8/4X3 w - - 0 1", "4k3/8/8/8/8/8/8/4K3 x - - 0 1",
+          "4k3/8/8/8/8/8/8/4K3 w Z - 0 1", "4k3/8/8/8/8/8/8/4K3 w - e9 0 1"}) {
+      CHECK(board.parse_fen(fen) == 0);
+    }
+  }
+}
+
+TEST_CASE("epd batch loading") {
+  const std::string text = "# comment\n"
+                           "4k3/8/8/8/8/8/8/4K3 w - - 0 1\n"
+                           "\n"
+                           "4k3/8/8/8/8/8/8/R3K3 w Q - bm Ra8; id \"2\";\r\n"
+                           "not a position\n"
+                           "4k3/8/8/8/8/8/8/3QK3 b - - 3 7";
+  SECTION("single thread") {
+    std::vector<Board> boards;
+    CHECK(Epd::parse(text, &boards) == 1);
+    REQUIRE(boards.size() == 3);
+    CHECK(boards[1].export_fen() == "4k3/8/8/8/8/8/8/R3K3 w Q - 0 1");
+    CHECK(boards[2].export_fen() == "4k3/8/8/8/8/8/8/3QK3 b - - 3 7");
+  }
+  SECTION("threads keep the order of the lines") {
+    std::string many;
+    for (int i = 0; i < 200; ++i) {
+      many += text + "\n";
+    }
+    std::vector<Board> one;
+    std::vector<Board> four;
+    Epd::parse(many, &one, 1);
+    CHECK(Epd::parse(many, &four, 4) == 200);
+    REQUIRE(one.size() == 600);
+    REQUIRE(four.size() == one.size());
+    for (std::size_t i = 0; i < one.size(); ++i) {
+      CHECK(four[i].export_fen() == one[i].export_fen());
+    }
+  }
+  SECTION("from a file") {
+    const std::string path = "epd-test.epd";
+    std::ofstream(path) << text;
+    std::vector<Board> boards;
+    CHECK(Epd::load(path, &boards, 2));
+    CHECK(boards.size() == 3);
+    std::remove(path.c_str());
+    CHECK_FALSE(Epd::load(path, &boards));
+  }
+}
+
+TEST_CASE("write fen") {
+  Board board;
+  char buffer[Board::FEN_MAX];
+  SECTION("into a buffer") {
+    const std::string_view fen =
+        "rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR b Kq d6 65535 65535";
+    board.parse_fen(fen);
+    CHECK(std::string_view(buffer, board.write_fen(buffer)) == fen);
+  }
+  SECTION("many positions to a file") {
+    const std::string path = "fen-writer-test.epd";
+    std::vector<Board> boards;
+    for (const std::string_view fen :
+         {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+          "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+          "4k3/8/8/8/8/8/8/4K3 b - - 42 97"}) {
+      boards.emplace_back().parse_fen(fen);
+    }
+    // enough to fill several write blocks
+    for (std::size_t i = 0; boards.size() < 100000; ++i) {
+      boards.push_back(boards[i]);
+    }
+    REQUIRE(Epd::save(path, boards));
+    std::vector<Board> loaded;
+    REQUIRE(Epd::load(path, &loaded));
+    std::remove(path.c_str());
+    REQUIRE(loaded.size() == boards.size());
+    bool same = true;
+    for (std::size_t i = 0; i < boards.size(); ++i) {
+      same = same && loaded[i].export_fen() == boards[i].export_fen();
+    }
+    CHECK(same);
+  }
+}
@@ -43,3 +43,99 @@ TEST_CASE("import fen") {
     CHECK(board.export_fen() == s);
   }
 }
+
+TEST_CASE("undo move") {
+  Board board;
+  std::string s;
+  const auto check_every_move = [&board](const std::string &fen) {
+    board.import_fen(fen);
+    const Board before = board;
+    for (const Move move : board.legal_moves(board.game_state.active_color)) {
+      const Undo undo = board.do_move(move);
+      board.undo_move(move, undo);
+      CHECK(board.export_fen() == fen);
+      CHECK(board.by_piece == before.by_piece);
+      CHECK(board.by_color == before.by_color);
+      CHECK(board.mailbox == before.mailbox);
+    }
+  };
+  SECTION("castling and captures") {
+    check_every_move(
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+  }
+  SECTION("promotions") {
+    check_every_move(
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 b kq - 0 1");
+  }
+  SECTION("en passant") {
+    check_every_move(
+        "rnbqkbnr/pp1p1ppp/8/2pPp3/8/8/PPP1PPPP/RNBQKBNR w KQkq c6 0 3");
+  }
+}
+
+TEST_CASE("zobrist key") {
+  Board board;
+  SECTION("default board matches imported start position") {
+    const uint64_t key = board.key;
+    board.import_fen(
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+    CHECK(board.key == key);
+  }
+  SECTION("transposition") {
+    Board other;
+    board.do_move(Square::g1, Square::f3, 0);
+    board.do_move(Square::g8, Square::f6, 0);
+    board.do_move(Square::b1, Square::c3, 0);
+    other.do_move(Square::b1, Square::c3, 0);
+    other.do_move(Square::g8, Square::f6, 0);
+    other.do_move(Square::g1, Square::f3, 0);
+    CHECK(board.key == other.key);
+    CHECK(board.key == board.compute_key());
+  }
+  SECTION("side to move, castling and en passant") {
+    board.import_fen("4k3/8/8/8/4p3/8/3P4/R3K2R w KQ - 0 1");
+    const uint64_t key = board.key;
+    board.import_fen("4k3/8/8/8/4p3/8/3P4/R3K2R b KQ - 0 1");
+    CHECK(board.key != key);
+    board.import_fen("4k3/8/8/8/4p3/8/3P4/R3K2R w K - 0 1");
+    CHECK(board.key != key);
+    board.import_fen("4k3/8/8/8/3Pp3/8/8/R3K2R b KQ d3 0 1");
+    const uint64_t ep = board.key;
+    board.import_fen("4k3/8/8/8/3Pp3/8/8/R3K2R b KQ - 0 1");
+    CHECK(board.key != ep);
+  }
+}
+
+TEST_CASE("attackers to") {
+  Board board;
+  board.import_fen("4k3/8/8/3q1r2/4P3/5N2/8/3RK3 w - - 0 1");
+  const uint64_t attackers = board.attackers_to(Square::d5, board.occupied());
+  CHECK(attackers == (bitboard::square(Square::e4) |
+                      bitboard::square(Square::d1) |
+                      bitboard::square(Square::f5)));
+  CHECK(board.is_attacked(Square::d5, Color::white));
+  CHECK(board.is_attacked(Square::d5, Color::black));
+  CHECK(board.is_attacked(Square::e1, Color::black) == false);
+  CHECK(board.is_attacked(Square::f4, Color::black));
+  CHECK(board.is_attacked(Square::f2, Color::black) == false); // knight blocks
+  CHECK(board.is_attacked(Square::g5, Color::white)); // knight on f3
+}
+
+TEST_CASE("count legal moves") {
+  Board board;
+  for (const std::string fen :
+       {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "4k3/8/8/8/8/4Nn2/8/1r2K3 w - - 0 1",  // double check
+        "7k/5Q2/6K1/8/8/8/8/8 b - - 0 1",      // stalemate
+        "R5k1/5ppp/8/8/8/8/8/6K1 b - - 0 1"}) { // checkmate
+    board.import_fen(fen);
+    for (const Color c : {Color::white, Color::black}) {
+      const unsigned n = board.legal_moves(c).size();
+      CHECK(board.count_legal_moves(c) == n);
+      CHECK(board.has_legal_move(c) == (n > 0));
+    }
+  }
+}
@@ -3,13 +3,8 @@
 
 void generate_and_sort_influence(Board &board, const Square &sq,
                                  std::vector<Square> &v) {
-  board.update_influence_maps();
-  Color c = board.what_color(sq);
-  if (c == Color::white) {
-    v = board.maps->white_influence[sq];
-  }
-  if (c == Color::black) {
-    v = board.maps->black_influence[sq];
+  if (board.what_color(sq) != Color::none) {
+    v = board.influence(sq);
   }
   std::sort(v.begin(), v.end());
 }
@@ -5,13 +5,24 @@
 void generate_and_sort_mbc(Board &board, const Square &sq,
                            std::vector<Square> &v) {
   v.clear();
-  board.update_move_maps();
   Color c = board.what_color(sq);
   if (c == Color::white) {
-    v = board.maps->white_moves[sq];
+    v.clear();
+    for (const Move move : board.legal_moves(Color::white)) {
+      if (move.from() == sq &&
+          (!move.is_promotion() || move.promotion_piece() == 'q')) {
+        v.push_back(move.to()); // one entry per promotion square
+      }
+    }
   }
   if (c == Color::black) {
-    v = board.maps->black_moves[sq];
+    v.clear();
+    for (const Move move : board.legal_moves(Color::black)) {
+      if (move.from() == sq &&
+          (!move.is_promotion() || move.promotion_piece() == 'q')) {
+        v.push_back(move.to()); // one entry per promotion square
+      }
+    }
   }
   std::sort(v.begin(), v.end());
 }
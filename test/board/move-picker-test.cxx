@@ -0,0 +1,100 @@
+#include "../../include/Move_Picker.h"
+#include <catch2/catch_all.hpp>
+
+#include <algorithm>
+#include <vector>
+
+std::vector<Move> picked(const Board &board, const Move hash_move,
+                         const std::array<Move, 2> killers) {
+  Move_Picker picker(board, hash_move, killers);
+  std::vector<Move> moves;
+  for (Move m; (m = picker.next()) != Move::none();) {
+    moves.push_back(m);
+  }
+  return moves;
+}
+
+bool same_moves(std::vector<Move> picked, const MoveList &legal) {
+  std::vector<Move> expected(legal.begin(), legal.end());
+  const auto order = [](const Move a, const Move b) {
+    return a.uci() < b.uci() || (a.uci() == b.uci() && a.flags() < b.flags());
+  };
+  std::sort(picked.begin(), picked.end(), order);
+  std::sort(expected.begin(), expected.end(), order);
+  return picked == expected;
+}
+
+TEST_CASE("move picker") {
+  Board board;
+  const auto none = Move::none();
+
+  SECTION("every legal move exactly once") {
+    for (const std::string fen :
+         {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+          "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+          "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+          "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"}) {
+      board.import_fen(fen);
+      const MoveList legal = board.legal_moves(board.game_state.active_color);
+      CHECK(same_moves(picked(board, none, {none, none}), legal));
+    }
+  }
+  SECTION("captures first, most valuable victim first") {
+    board.import_fen("4k3/8/8/3q1r2/4P3/8/8/3RK3 w - - 0 1");
+    const std::vector<Move> moves = picked(board, none, {none, none});
+    REQUIRE(moves.size() >= 3);
+    CHECK(moves[0].uci() == "e4d5"); // pawn takes queen
+    CHECK(moves[1].uci() == "d1d5"); // rook takes queen
+    CHECK(moves[2].uci() == "e4f5"); // pawn takes rook
+    CHECK(!moves[3].is_capture());
+  }
+  SECTION("hash move first, killers after captures, none repeated") {
+    board.import_fen("4k3/8/8/3q1r2/4P3/8/8/3RK3 w - - 0 1");
+    const Move hash_move(Square::e1, Square::e2);
+    const Move killer(Square::d1, Square::a1);
+    const std::vector<Move> moves =
+        picked(board, hash_move, {killer, killer});
+    const MoveList legal = board.legal_moves(Color::white);
+    CHECK(same_moves(moves, legal));
+    CHECK(moves[0] == hash_move);
+    CHECK(moves[4] == killer);
+  }
+  SECTION("stale hash move and killers are skipped") {
+    board.import_fen("4k3/8/8/3q1r2/4P3/8/8/3RK3 w - - 0 1");
+    const Move illegal(Square::e4, Square::e6);
+    const std::vector<Move> moves =
+        picked(board, illegal, {Move(Square::a1, Square::a2), illegal});
+    CHECK(same_moves(moves, board.legal_moves(Color::white)));
+  }
+  SECTION("losing captures last") {
+    board.import_fen("4k3/8/2p5/3p4/8/8/8/3RK3 w - - 0 1");
+    const std::vector<Move> moves = picked(board, none, {none, none});
+    CHECK(same_moves(moves, board.legal_moves(Color::white)));
+    CHECK(moves.back().uci() == "d1d5"); // the pawn on c6 takes back
+  }
+  SECTION("evasions") {
+    // single check: capture the rook, block, or step aside
+    board.import_fen("4k3/8/8/8/8/4N3/8/1r2K3 w - - 0 1");
+    MoveList evasions;
+    board.generate_pseudo_legal(Color::white, &evasions, Gen_Type::evasions);
+    for (const Move move : evasions) {
+      CHECK((move.from() == Square::e1 || move.to() == Square::b1 ||
+             move.to() == Square::c1 || move.to() == Square::d1));
+    }
+    CHECK(same_moves(picked(board, none, {none, none}),
+                     board.legal_moves(Color::white)));
+    // double check: only the king moves
+    board.import_fen("4k3/8/8/8/8/4Nn2/8/1r2K3 w - - 0 1");
+    evasions.clear();
+    board.generate_pseudo_legal(Color::white, &evasions, Gen_Type::evasions);
+    for (const Move move : evasions) {
+      CHECK(move.from() == Square::e1);
+    }
+    CHECK(same_moves(picked(board, none, {none, none}),
+                     board.legal_moves(Color::white)));
+  }
+  SECTION("no moves") {
+    board.import_fen("7k/5Q2/6K1/8/8/8/8/8 b - - 0 1");
+    CHECK(picked(board, none, {none, none}).empty());
+  }
+}
@@ -0,0 +1,53 @@
+#include "../../include/Board.h"
+#include <catch2/catch_all.hpp>
+
+TEST_CASE("packed position") {
+  Board board;
+  Packed_Position packed{};
+  SECTION("round trip") {
+    for (const std::string fen :
+         {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+          "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+          "rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR w Kq d6 0 3",
+          "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 b - - 99 1234",
+          "8/8/8/8/8/8/8/8 w - - 0 1"}) {
+      board.import_fen(fen);
+      REQUIRE(board.encode(&packed));
+      Board decoded;
+      REQUIRE(decoded.decode(packed));
+      CHECK(decoded.export_fen() == fen);
+      CHECK(decoded.key == board.key);
+    }
+  }
+  SECTION("layout") {
+    board.import_fen("4k3/8/8/8/8/8/8/4K2R b K e3 5 300");
+    REQUIRE(board.encode(&packed));
+    // h1, e1 and e8, lowest square first
+    CHECK(packed[0] == 0x09);
+    CHECK(packed[7] == 0x08);
+    CHECK(packed[8] == (4 | 6 << 4)); // R, K
+    CHECK(packed[9] == 12);           // k
+    CHECK(packed[24] == (1 | 1 << 1));
+    CHECK(packed[25] == static_cast<uint8_t>(Square::e3));
+    CHECK(packed[26] == 5);
+    CHECK(packed[28] == (300 & 0xFF));
+    CHECK(packed[29] == 300 >> 8);
+  }
+  SECTION("too many pieces") {
+    board.import_fen("nnnnnnnn/nnnnnnnn/nnnnnnnn/nnnnnnnn/N7/8/8/8 w - - 0 1");
+    CHECK_FALSE(board.encode(&packed));
+  }
+  SECTION("malformed") {
+    board.encode(&packed);
+    Packed_Position bad = packed;
+    bad[8] &= 0xF0; // no piece on an occupied square
+    CHECK_FALSE(board.decode(bad));
+    CHECK(board.occupied() == 0);
+    bad = packed;
+    bad[25] = 65;
+    CHECK_FALSE(board.decode(bad));
+    bad = packed;
+    bad[31] = 1;
+    CHECK_FALSE(board.decode(bad));
+  }
+}
@@ -0,0 +1,159 @@
+#include "../../include/Perft.h"
+#include <catch2/catch_all.hpp>
+
+#include <set>
+
+uint64_t perft_from(const std::string &fen, const uint depth) {
+  Board board;
+  board.import_fen(fen);
+  return Perft::count(board, depth);
+}
+
+// reference counts from https://www.chessprogramming.org/Perft_Results
+TEST_CASE("perft") {
+  SECTION("start position") {
+    CHECK(perft_from("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+                     4) == 197281);
+  }
+  SECTION("kiwipete") {
+    CHECK(perft_from("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R "
+                     "w KQkq - 0 1",
+                     3) == 97862);
+  }
+  SECTION("position 3") {
+    CHECK(perft_from("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 5) ==
+          674624);
+  }
+  SECTION("position 4") {
+    CHECK(perft_from("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 "
+                     "w kq - 0 1",
+                     4) == 422333);
+  }
+  SECTION("position 5") {
+    CHECK(perft_from("rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R "
+                     "w KQ - 1 8",
+                     3) == 62379);
+  }
+  SECTION("position 6") {
+    CHECK(perft_from("r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/"
+                     "R4RK1 w - - 0 10",
+                     3) == 89890);
+  }
+}
+
+TEST_CASE("perft divide") {
+  Board board;
+  std::ostringstream out;
+  CHECK(Perft::divide(board, 2, out) == 400);
+  CHECK(out.str().find("e2e4: 20\n") != std::string::npos);
+  CHECK(out.str().find("Nodes searched: 400") != std::string::npos);
+}
+
+TEST_CASE("perft threads") {
+  Board board;
+  board.import_fen(
+      "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+  CHECK(Perft::count(board, 4, 4) == 4085603);
+  CHECK(Perft::count(board, 1, 3) == 48);
+  std::ostringstream out;
+  CHECK(Perft::divide(board, 3, out, 2) == 97862);
+}
+
+TEST_CASE("perft hash table") {
+  Board board;
+  board.import_fen(
+      "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+  Perft_Table table(1);
+  CHECK(Perft::count(board, 4, &table) == 4085603);
+  CHECK(table.hit_rate() > 0);
+  // a second run finds everything it needs near the root
+  CHECK(Perft::count(board, 4, 2, &table) == 4085603);
+  CHECK(Perft::count(board, 5, 2, &table) == 193690690);
+}
+
+uint64_t perft_pseudo_legal(Board &board, const uint depth) {
+  if (depth == 0) {
+    return 1;
+  }
+  const Color c = board.game_state.active_color;
+  const Check_Info info = board.check_info(c);
+  MoveList moves;
+  board.generate_pseudo_legal(c, &moves,
+                              info.checkers ? Gen_Type::evasions
+                                            : Gen_Type::all);
+  uint64_t nodes = 0;
+  for (const Move move : moves) {
+    if (board.is_legal(move, info)) {
+      const Undo undo = board.do_move(move);
+      nodes += perft_pseudo_legal(board, depth - 1);
+      board.undo_move(move, undo);
+    }
+  }
+  return nodes;
+}
+
+TEST_CASE("perft pseudo-legal") {
+  for (const std::string fen :
+       {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8"}) {
+    Board board;
+    board.import_fen(fen);
+    CHECK(perft_pseudo_legal(board, 3) == Perft::count(board, 3));
+  }
+}
+
+// compare the quiet checks with the legal quiet moves that leave the enemy in
+// check, at every node of a small tree that is not itself in check
+bool quiet_checks_match(Board &board, const uint depth) {
+  const Color c = board.game_state.active_color;
+  Color enemy = c;
+  !enemy;
+  std::set<std::string> expected;
+  for (const Move move : board.legal_moves(c)) {
+    if (!move.is_capture() && !move.is_promotion() && !move.is_castle()) {
+      const Undo undo = board.do_move(move);
+      if (board.in_check(enemy)) {
+        expected.insert(move.uci());
+      }
+      board.undo_move(move, undo);
+    }
+  }
+  MoveList moves;
+  board.generate_quiet_checks(c, &moves);
+  const Check_Info info = board.check_info(c);
+  std::set<std::string> generated;
+  for (const Move move : moves) {
+    if (board.is_legal(move, info)) {
+      generated.insert(move.uci());
+    }
+  }
+  if (!info.checkers && generated != expected) {
+    return false;
+  }
+  if (depth > 0) {
+    for (const Move move : board.legal_moves(c)) {
+      const Undo undo = board.do_move(move);
+      const bool ok = quiet_checks_match(board, depth - 1);
+      board.undo_move(move, undo);
+      if (!ok) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+TEST_CASE("quiet checks") {
+  for (const std::string fen :
+       {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "3k4/8/8/8/8/8/3B4/K2R4 w - - 0 1"}) {
+    Board board;
+    board.import_fen(fen);
+    CHECK(quiet_checks_match(board, 2));
+  }
+}
@@ -0,0 +1,60 @@
+#include "../../include/Board.h"
+#include <catch2/catch_all.hpp>
+
+int see(const std::string &fen, const Square from, const Square to,
+        const uint16_t flags = Move::capture) {
+  Board board;
+  board.import_fen(fen);
+  return board.see(Move(from, to, flags));
+}
+
+TEST_CASE("static exchange evaluation") {
+  SECTION("undefended piece") {
+    CHECK(see("4k3/8/8/3r4/8/8/8/3RK3 w - - 0 1", Square::d1, Square::d5) ==
+          500);
+  }
+  SECTION("defended piece") {
+    // rook takes pawn, pawn takes rook
+    CHECK(see("4k3/8/2p5/3p4/8/8/8/3RK3 w - - 0 1", Square::d1, Square::d5) ==
+          -400);
+    // pawn takes knight, pawn takes pawn
+    CHECK(see("4k3/8/2p5/3n4/4P3/8/8/4K3 w - - 0 1", Square::e4, Square::d5) ==
+          200);
+  }
+  SECTION("x-ray") {
+    // the queen behind the rook decides it: RxR, rxR, QxR
+    CHECK(see("3rk3/8/8/3r4/8/8/3R4/3QK3 w - - 0 1", Square::d2, Square::d5) ==
+          500);
+  }
+  SECTION("quiet move to an attacked square") {
+    CHECK(see("4k3/8/2p5/8/8/8/8/3QK3 w - - 0 1", Square::d1, Square::d5,
+              Move::quiet) == -900);
+    CHECK(see("4k3/8/8/8/8/8/8/3QK3 w - - 0 1", Square::d1, Square::d5,
+              Move::quiet) == 0);
+  }
+  SECTION("the king can't take a defended piece") {
+    CHECK(see("4k3/8/8/8/8/8/3q4/4K3 w - - 0 1", Square::e1, Square::d2) ==
+          900);
+    CHECK(see("4k3/8/8/8/8/8/3p4/4K3 w - - 0 1", Square::e1, Square::d2) ==
+          100);
+    CHECK(see("4k3/8/8/8/8/8/3pr3/4K3 w - - 0 1", Square::e1, Square::d2) ==
+          100);
+  }
+  SECTION("see_ge agrees with see") {
+    for (const std::string fen :
+         {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+          "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+          "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+          "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 "
+          "10"}) {
+      Board board;
+      board.import_fen(fen);
+      for (const Move move : board.legal_moves(Color::white)) {
+        const int value = board.see(move);
+        for (const int margin : {-1000, -500, -1, 0, 1, 100, 500, 1000}) {
+          CHECK(board.see_ge(move, margin) == (value >= margin));
+        }
+      }
+    }
+  }
+}
@@ -6,13 +6,11 @@
 
 double test_s(const std::string &fen) {
   const auto n = make_shared<Node>(fen);
-  n->board()->update_move_maps();
   return Eval::stacked_pawns(n.get()) / Eval::STACKED_PAWN_PENALTY;
 }
 
 double test_p(const std::string &fen) {
   const auto n = std::make_shared<Node>(fen);
-  n->board()->update_move_maps();
   return Eval::passed_pawns(n.get()) / Eval::PASSED_PAWN_BONUS;
 }
 